@@ -2,6 +2,7 @@
 #include "CutterApplication.h"
 #include "plugins/PluginManager.h"
 #include "CutterConfig.h"
+#include "common/BatchDecompiler.h"
 #include "common/Decompiler.h"
 #include "common/ResourcePaths.h"
 
@@ -19,6 +20,7 @@
 #include <QTranslator>
 #include <QLibraryInfo>
 #include <QFontDatabase>
+#include <QTimer>
 #ifdef Q_OS_WIN
 #    include <QtNetwork/QtNetwork>
 #endif // Q_OS_WIN
@@ -91,7 +93,10 @@ CutterApplication::CutterApplication(int &argc, char **argv) : QApplication(argc
     QString rzversion = rz_core_version();
     QString localVersion = CUTTER_COMPILE_TIME_RZ_VERSION;
     qDebug() << rzversion << localVersion;
-    if (rzversion != localVersion) {
+    if (rzversion != localVersion && isBatchMode()) {
+        qWarning() << "The version used to compile Cutter" << localVersion
+                   << "does not match the binary version of rizin" << rzversion;
+    } else if (rzversion != localVersion) {
         QMessageBox msg;
         msg.setIcon(QMessageBox::Critical);
         msg.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
@@ -130,26 +135,35 @@ CutterApplication::CutterApplication(int &argc, char **argv) : QApplication(argc
         plugin->registerDecompilers();
     }
 
-    mainWindow = new MainWindow();
-    installEventFilter(mainWindow);
+    if (isBatchMode()) {
+        auto batch = new BatchDecompiler(clOptions.fileOpenOptions, clOptions.decompileOutputDir,
+                                         clOptions.decompilerId, clOptions.decompileWorkers, this);
+        connect(batch, &BatchDecompiler::finished, this,
+                [](int exitCode) { QCoreApplication::exit(exitCode); });
+        // Started from the event loop, exit() has no effect before
+        QTimer::singleShot(0, batch, &BatchDecompiler::start);
+    } else {
+        mainWindow = new MainWindow();
+        installEventFilter(mainWindow);
 
-    // set up context menu shortcut display fix
+        // set up context menu shortcut display fix
 #if QT_VERSION_CHECK(5, 10, 0) < QT_VERSION
-    setStyle(new CutterProxyStyle());
+        setStyle(new CutterProxyStyle());
 #endif // QT_VERSION_CHECK(5, 10, 0) < QT_VERSION
 
-    if (clOptions.args.empty() && clOptions.fileOpenOptions.projectFile.isEmpty()) {
-        // check if this is the first execution of Cutter in this computer
-        // Note: the execution after the preferences been reset, will be considered as
-        // first-execution
-        if (Config()->isFirstExecution()) {
-            mainWindow->displayWelcomeDialog();
+        if (clOptions.args.empty() && clOptions.fileOpenOptions.projectFile.isEmpty()) {
+            // check if this is the first execution of Cutter in this computer
+            // Note: the execution after the preferences been reset, will be considered as
+            // first-execution
+            if (Config()->isFirstExecution()) {
+                mainWindow->displayWelcomeDialog();
+            }
+            mainWindow->displayNewFileDialog();
+        } else { // filename specified as positional argument
+            bool askOptions = (clOptions.analysisLevel != AutomaticAnalysisLevel::Ask)
+                    || !clOptions.fileOpenOptions.projectFile.isEmpty();
+            mainWindow->openNewFile(clOptions.fileOpenOptions, askOptions);
         }
-        mainWindow->displayNewFileDialog();
-    } else { // filename specified as positional argument
-        bool askOptions = (clOptions.analysisLevel != AutomaticAnalysisLevel::Ask)
-                || !clOptions.fileOpenOptions.projectFile.isEmpty();
-        mainWindow->openNewFile(clOptions.fileOpenOptions, askOptions);
     }
 
 #ifdef APPIMAGE
@@ -214,7 +228,7 @@ bool CutterApplication::event(QEvent *e)
 {
     if (e->type() == QEvent::FileOpen) {
         QFileOpenEvent *openEvent = static_cast<QFileOpenEvent *>(e);
-        if (openEvent) {
+        if (openEvent && mainWindow) {
             if (m_FileAlreadyDropped) {
                 // We already dropped a file in macOS, let's spawn another instance
                 // (Like the File -> Open)
@@ -469,6 +483,25 @@ bool CutterApplication::parseCommandLineOptions()
                                            QObject::tr("Do not load rizin plugins"));
     cmd_parser.addOption(disableRizinPlugins);
 
+    QCommandLineOption decompileAllOption(
+            "decompile-all",
+            QObject::tr("Do not start the GUI, analyze the file and decompile all functions into "
+                        "a JSON file per function and an index.json in the given directory. "
+                        "Uses aaa analysis unless specified otherwise."),
+            QObject::tr("directory"));
+    cmd_parser.addOption(decompileAllOption);
+
+    QCommandLineOption decompilerOption(
+            "decompiler", QObject::tr("Decompiler to use with --decompile-all"), QObject::tr("id"));
+    cmd_parser.addOption(decompilerOption);
+
+    QCommandLineOption decompileWorkersOption(
+            "decompile-workers",
+            QObject::tr("Number of threads writing the results of --decompile-all, "
+                        "0 for one per core"),
+            QObject::tr("count"));
+    cmd_parser.addOption(decompileWorkersOption);
+
     cmd_parser.process(*this);
 
     CutterCommandLineOptions opts;
@@ -498,6 +531,33 @@ bool CutterApplication::parseCommandLineOptions()
         }
     }
 
+    if (cmd_parser.isSet(decompileAllOption)) {
+        opts.decompileOutputDir = cmd_parser.value(decompileAllOption);
+        opts.decompilerId = cmd_parser.value(decompilerOption);
+        if (cmd_parser.isSet(decompileWorkersOption)) {
+            bool ok = false;
+            opts.decompileWorkers = cmd_parser.value(decompileWorkersOption).toInt(&ok);
+            if (!ok || opts.decompileWorkers < 0) {
+                fprintf(stderr, "%s\n",
+                        QObject::tr("Invalid number of decompile workers.")
+                                .toLocal8Bit()
+                                .constData());
+                return false;
+            }
+        }
+        if (opts.args.empty()) {
+            fprintf(stderr, "%s\n",
+                    QObject::tr("Filename must be specified to decompile all functions.")
+                            .toLocal8Bit()
+                            .constData());
+            return false;
+        }
+        if (opts.analysisLevel == AutomaticAnalysisLevel::Ask) {
+            // Nobody can be asked
+            opts.analysisLevel = AutomaticAnalysisLevel::AAA;
+        }
+    }
+
     if (opts.args.empty() && opts.analysisLevel != AutomaticAnalysisLevel::Ask) {
         fprintf(stderr, "%s\n",
                 QObject::tr("Filename must be specified to start analysis automatically.")
@@ -570,6 +630,13 @@ bool CutterApplication::parseCommandLineOptions()
     }
 
     opts.fileOpenOptions.projectFile = cmd_parser.value(projectOption);
+    if (!opts.decompileOutputDir.isEmpty() && !opts.fileOpenOptions.projectFile.isEmpty()) {
+        fprintf(stderr, "%s\n",
+                QObject::tr("Projects can't be decompiled with --decompile-all.")
+                        .toLocal8Bit()
+                        .constData());
+        return false;
+    }
 
     if (cmd_parser.isSet(pythonHomeOption)) {
         opts.pythonHome = cmd_parser.value(pythonHomeOption);
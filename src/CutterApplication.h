@@ -19,6 +19,10 @@ struct CutterCommandLineOptions
     bool outputRedirectionEnabled = true;
     bool enableCutterPlugins = true;
     bool enableRizinPlugins = true;
+    /// Output directory of the headless batch decompilation, empty to start the GUI
+    QString decompileOutputDir;
+    QString decompilerId;
+    int decompileWorkers = 0;
 };
 
 class CutterApplication : public QApplication
@@ -36,6 +40,10 @@ public:
     InitialOptions getInitialOptions() const { return clOptions.fileOpenOptions; }
     void setInitialOptions(const InitialOptions &options) { clOptions.fileOpenOptions = options; }
     QStringList getArgs() const;
+    /**
+     * @return whether Cutter runs without main window, decompiling all functions of a file
+     */
+    bool isBatchMode() const { return !clOptions.decompileOutputDir.isEmpty(); }
 
 protected:
     bool event(QEvent *e);
@@ -55,7 +63,7 @@ private:
 private:
     bool m_FileAlreadyDropped;
     CutterCore core;
-    MainWindow *mainWindow;
+    MainWindow *mainWindow = nullptr;
     CutterCommandLineOptions clOptions;
 };
 
@@ -59,7 +59,9 @@ int main(int argc, char *argv[])
 #endif
 
     qRegisterMetaType<QList<StringDescription>>();
+    qRegisterMetaType<StringDescriptionColumns>();
     qRegisterMetaType<QList<FunctionDescription>>();
+    qRegisterMetaType<FunctionsDelta>();
 
     QCoreApplication::setOrganizationName("rizin");
 #ifndef Q_OS_MACOS // don't set on macOS so that it doesn't affect config path there
@@ -89,7 +91,7 @@ int main(int argc, char *argv[])
 
     Cutter::migrateThemes();
 
-    if (Config()->getAutoUpdateEnabled()) {
+    if (Config()->getAutoUpdateEnabled() && !a.isBatchMode()) {
 #if CUTTER_UPDATE_WORKER_AVAILABLE
         UpdateWorker *updateWorker = new UpdateWorker;
         QObject::connect(updateWorker, &UpdateWorker::checkComplete,
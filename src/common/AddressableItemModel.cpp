@@ -1,5 +1,9 @@
 #include <stdexcept>
 #include "AddressableItemModel.h"
+#include "common/TrigramIndex.h"
+#include "core/Cutter.h"
+
+#include <QTimer>
 
 #include <stdexcept>
 
@@ -11,6 +15,13 @@ AddressableFilterProxyModel::AddressableFilterProxyModel(AddressableItemModelI *
     addressableSourceModel = sourceModel;
 }
 
+AddressableFilterProxyModel::~AddressableFilterProxyModel()
+{
+    if (filterIndexTask) {
+        filterIndexTask->interrupt();
+    }
+}
+
 RVA AddressableFilterProxyModel::address(const QModelIndex &index) const
 {
     if (!addressableSourceModel) {
@@ -34,6 +45,305 @@ void AddressableFilterProxyModel::setSourceModel(QAbstractItemModel *)
 
 void AddressableFilterProxyModel::setSourceModel(AddressableItemModelI *sourceModel)
 {
-    ParentClass::setSourceModel(sourceModel ? sourceModel->asItemModel() : nullptr);
+    QAbstractItemModel *model = sourceModel ? sourceModel->asItemModel() : nullptr;
+    connectSourceModel(model);
+    ParentClass::setSourceModel(model);
     addressableSourceModel = sourceModel;
 }
+
+bool AddressableFilterProxyModel::sortKey(int sourceRow, int column, SortKey &key) const
+{
+    if (column != commentColumn || !addressableSourceModel) {
+        return false;
+    }
+    RVA address = addressableSourceModel->address(sourceModel()->index(sourceRow, 0));
+    key.text = Core()->getCommentAt(address);
+    return true;
+}
+
+bool AddressableFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    if (!left.parent().isValid() && !right.parent().isValid()
+        && left.column() == right.column()) {
+        CachedSortKey leftKey = cachedSortKey(left.row(), left.column());
+        if (leftKey.hasKey) {
+            CachedSortKey rightKey = cachedSortKey(right.row(), right.column());
+            if (rightKey.hasKey) {
+                return leftKey.key < rightKey.key;
+            }
+        }
+    }
+    return ParentClass::lessThan(left, right);
+}
+
+QString AddressableFilterProxyModel::filterKey(int sourceRow) const
+{
+    return sourceModel()->index(sourceRow, filterKeyColumn()).data(filterRole()).toString();
+}
+
+bool AddressableFilterProxyModel::filterKeyContains(int sourceRow) const
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QString pattern = filterRegExp().pattern();
+#else
+    QString pattern = filterRegularExpression().pattern();
+#endif
+    if (pattern.isEmpty()) {
+        return true;
+    }
+    bool lower = filterCaseSensitivity() == Qt::CaseInsensitive;
+    if (pattern != matchesPattern || lower != matchesLower) {
+        // Such patterns mean the same as wildcard, regular expression and escaped fixed string
+        bool literal = std::all_of(pattern.begin(), pattern.end(), [](QChar c) {
+            return c.unicode() < 128 && (c.isLetterOrNumber() || c == QLatin1Char('_'));
+        });
+        if (!literal) {
+            return qhelpers::filterStringContains(filterKey(sourceRow), this);
+        }
+        updateFilterMatches(pattern, lower);
+    }
+
+    if (sourceRow >= filterMatches.values.size()) {
+        filterMatches.resize(sourceModel()->rowCount());
+    }
+    if (sourceRow >= filterMatches.values.size()) {
+        return keyContains(sourceRow, matchesNeedle, lower);
+    }
+    if (!filterMatches.ready[sourceRow]) {
+        filterMatches.values[sourceRow] = keyContains(sourceRow, matchesNeedle, lower);
+        filterMatches.ready[sourceRow] = true;
+    }
+    return filterMatches.values[sourceRow];
+}
+
+bool AddressableFilterProxyModel::keyContains(int sourceRow, const QString &needle,
+                                              bool lower) const
+{
+    if (lower != filterKeysLower) {
+        filterKeys.clear();
+        filterKeysLower = lower;
+    }
+    if (sourceRow >= filterKeys.values.size()) {
+        filterKeys.resize(sourceModel()->rowCount());
+    }
+    if (sourceRow >= filterKeys.values.size()) {
+        QString key = filterKey(sourceRow);
+        return (lower ? key.toLower() : key).contains(needle);
+    }
+    if (!filterKeys.ready[sourceRow]) {
+        QString key = filterKey(sourceRow);
+        filterKeys.values[sourceRow] = lower ? key.toLower() : key;
+        filterKeys.ready[sourceRow] = true;
+    }
+    return filterKeys.values[sourceRow].contains(needle);
+}
+
+void AddressableFilterProxyModel::updateFilterMatches(const QString &pattern, bool lower) const
+{
+    QString needle = lower ? pattern.toLower() : pattern;
+    int rows = sourceModel()->rowCount();
+    // Rows not containing the previous filter can't contain one extending it
+    bool narrowing =
+            !matchesNeedle.isEmpty() && lower == matchesLower && needle.contains(matchesNeedle);
+    RowCache<bool> previous;
+    if (narrowing) {
+        previous = filterMatches;
+    }
+    auto isCandidate = [&previous, narrowing](int row) {
+        return !narrowing || row >= previous.values.size() || !previous.ready[row]
+                || previous.values[row];
+    };
+
+    filterMatches.values.fill(false, rows);
+    filterMatches.ready.fill(true, rows);
+    matchesPattern = pattern;
+    matchesNeedle = needle;
+    matchesLower = lower;
+    auto verify = [this, &needle, lower](int row) {
+        filterMatches.values[row] = keyContains(row, needle, lower);
+    };
+
+    QVector<int> indexed;
+    if (filterIndex && filterIndex->rowCount() <= rows
+        && filterIndex->candidates(needle, indexed)) {
+        for (int row : indexed) {
+            if (isCandidate(row)) {
+                verify(row);
+            }
+        }
+        // Rows added since the index was built
+        for (int row = filterIndex->rowCount(); row < rows; row++) {
+            if (isCandidate(row)) {
+                verify(row);
+            }
+        }
+        return;
+    }
+    for (int row = 0; row < rows; row++) {
+        if (isCandidate(row)) {
+            verify(row);
+        }
+    }
+}
+
+void AddressableFilterProxyModel::setFilterIndexEnabled(bool enabled)
+{
+    filterIndexEnabled = enabled;
+    resetFilterIndex();
+}
+
+void AddressableFilterProxyModel::resetFilterIndex()
+{
+    if (filterIndexTask) {
+        filterIndexTask->interrupt();
+        filterIndexTask.clear();
+    }
+    filterIndex.reset();
+    filterIndexTexts.clear();
+    scheduleFilterIndexUpdate();
+}
+
+void AddressableFilterProxyModel::scheduleFilterIndexUpdate()
+{
+    if (!filterIndexEnabled || filterIndexUpdatePending) {
+        return;
+    }
+    // Wait for the change of the source model to complete, and merge consecutive changes
+    filterIndexUpdatePending = true;
+    QTimer::singleShot(0, this, [this]() {
+        filterIndexUpdatePending = false;
+        updateFilterIndex();
+    });
+}
+
+void AddressableFilterProxyModel::updateFilterIndex()
+{
+    if (!filterIndexEnabled || !sourceModel() || filterIndexTask) {
+        // A running task updates the index again when it has finished
+        return;
+    }
+    int rows = sourceModel()->rowCount();
+    int indexedRows = filterIndexTexts.size();
+    if (rows < FILTER_INDEX_MIN_ROWS || indexedRows >= rows) {
+        return;
+    }
+
+    QVector<QString> texts;
+    texts.reserve(rows - indexedRows);
+    for (int row = indexedRows; row < rows; row++) {
+        texts.append(filterKey(row));
+    }
+    filterIndexTexts += texts;
+
+    filterIndexTask.reset(new TrigramIndexTask(std::move(filterIndex), texts));
+    quint64 taskId = ++filterIndexTaskId;
+    TrigramIndexTask *task = filterIndexTask.data();
+    connect(task, &AsyncTask::finished, this, [this, taskId, task]() {
+        if (taskId != filterIndexTaskId || !filterIndexTask) {
+            // The index has been reset in the meantime
+            return;
+        }
+        filterIndex = task->takeIndex();
+        filterIndexTask.clear();
+        if (!filterIndex) {
+            filterIndexTexts.clear();
+            return;
+        }
+        updateFilterIndex();
+    });
+    Core()->getAsyncTaskManager()->start(filterIndexTask);
+}
+
+void AddressableFilterProxyModel::connectSourceModel(QAbstractItemModel *model)
+{
+    for (const auto &connection : sourceConnections) {
+        disconnect(connection);
+    }
+    sourceConnections.clear();
+    clearCaches();
+    if (!model) {
+        return;
+    }
+
+    // Connected before the proxy itself, so the caches are up to date when it handles changes
+    auto clear = [this]() { clearCaches(); };
+    sourceConnections << connect(model, &QAbstractItemModel::modelAboutToBeReset, this, clear);
+    sourceConnections << connect(model, &QAbstractItemModel::layoutAboutToBeChanged, this, clear);
+    sourceConnections << connect(model, &QAbstractItemModel::rowsAboutToBeMoved, this, clear);
+    sourceConnections << connect(model, &QAbstractItemModel::rowsAboutToBeInserted, this,
+                                 [this](const QModelIndex &parent, int first, int last) {
+                                     if (parent.isValid()) {
+                                         return;
+                                     }
+                                     sortKeys.insertRows(first, last - first + 1);
+                                     filterKeys.insertRows(first, last - first + 1);
+                                     filterMatches.insertRows(first, last - first + 1);
+                                     if (first < filterIndexTexts.size()) {
+                                         resetFilterIndex();
+                                     }
+                                 });
+    sourceConnections << connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+                                 [this](const QModelIndex &parent, int first, int last) {
+                                     if (parent.isValid()) {
+                                         return;
+                                     }
+                                     sortKeys.removeRows(first, last - first + 1);
+                                     filterKeys.removeRows(first, last - first + 1);
+                                     filterMatches.removeRows(first, last - first + 1);
+                                     if (first < filterIndexTexts.size()) {
+                                         resetFilterIndex();
+                                     }
+                                 });
+    sourceConnections << connect(
+            model, &QAbstractItemModel::dataChanged, this,
+            [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+                if (topLeft.parent().isValid()) {
+                    return;
+                }
+                sortKeys.invalidateRows(topLeft.row(), bottomRight.row());
+                filterKeys.invalidateRows(topLeft.row(), bottomRight.row());
+                filterMatches.invalidateRows(topLeft.row(), bottomRight.row());
+                int indexedRows = filterIndexTexts.size();
+                for (int row = topLeft.row(); row <= bottomRight.row() && row < indexedRows;
+                     row++) {
+                    if (filterKey(row) != filterIndexTexts[row]) {
+                        resetFilterIndex();
+                        break;
+                    }
+                }
+            });
+    sourceConnections << connect(model, &QAbstractItemModel::rowsInserted, this,
+                                 [this]() { scheduleFilterIndexUpdate(); });
+}
+
+void AddressableFilterProxyModel::clearCaches()
+{
+    sortKeys.clear();
+    filterKeys.clear();
+    filterMatches.clear();
+    matchesPattern.clear();
+    matchesNeedle.clear();
+    resetFilterIndex();
+}
+
+AddressableFilterProxyModel::CachedSortKey
+AddressableFilterProxyModel::cachedSortKey(int sourceRow, int column) const
+{
+    if (column != sortKeysColumn) {
+        sortKeys.clear();
+        sortKeysColumn = column;
+    }
+    if (sourceRow >= sortKeys.values.size()) {
+        sortKeys.resize(sourceModel()->rowCount());
+    }
+    if (sourceRow < 0 || sourceRow >= sortKeys.values.size()) {
+        return CachedSortKey();
+    }
+    if (!sortKeys.ready[sourceRow]) {
+        CachedSortKey &cached = sortKeys.values[sourceRow];
+        cached.key = SortKey();
+        cached.hasKey = sortKey(sourceRow, column, cached.key);
+        sortKeys.ready[sourceRow] = true;
+    }
+    return sortKeys.values[sourceRow];
+}
@@ -5,8 +5,19 @@
 #include <QAbstractItemModel>
 #include <QSortFilterProxyModel>
 #include <QAbstractItemModel>
+#include <QList>
+#include <QSharedPointer>
+#include <QVector>
 
 #include "core/CutterCommon.h"
+#include "core/ListDelta.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+class TrigramIndex;
+class TrigramIndexTask;
 
 class CUTTER_EXPORT AddressableItemModelI
 {
@@ -35,22 +46,249 @@ public:
     explicit AddressableItemModel(QObject *parent = nullptr) : ParentModel(parent) {}
     virtual ~AddressableItemModel() {}
     QAbstractItemModel *asItemModel() { return this; }
+
+protected:
+    /**
+     * @brief Apply \a delta to the top level \a rows shown by this model
+     *
+     * Emits row removals, insertions and dataChanged for the affected rows only, so views keep
+     * their scroll position and selection. New items are appended at the end.
+     * @param rowOf row of each key in rows, updated together with rows
+     * @param keyMember member of Value identifying the item
+     */
+    template<typename Key, typename Value>
+    void applyListDelta(QList<Value> &rows, QHash<Key, int> &rowOf,
+                        const ListDelta<Key, Value> &delta, Key Value::*keyMember)
+    {
+        if (delta.reset) {
+            this->beginResetModel();
+            rows = delta.updated;
+            rowOf.clear();
+            for (int i = 0; i < rows.size(); i++) {
+                rowOf.insert(rows[i].*keyMember, i);
+            }
+            this->endResetModel();
+            return;
+        }
+
+        QList<int> removedRows;
+        for (const Key &key : delta.removed) {
+            auto it = rowOf.constFind(key);
+            if (it != rowOf.constEnd()) {
+                removedRows.append(it.value());
+            }
+        }
+        if (!removedRows.isEmpty()) {
+            std::sort(removedRows.begin(), removedRows.end(), std::greater<int>());
+            for (int i = 0; i < removedRows.size();) {
+                // Remove ranges of adjacent rows at once, starting at the end
+                int last = removedRows[i];
+                int first = last;
+                for (i++; i < removedRows.size() && removedRows[i] == first - 1; i++) {
+                    first--;
+                }
+                this->beginRemoveRows(QModelIndex(), first, last);
+                rows.erase(rows.begin() + first, rows.begin() + last + 1);
+                this->endRemoveRows();
+            }
+            rowOf.clear();
+            for (int i = 0; i < rows.size(); i++) {
+                rowOf.insert(rows[i].*keyMember, i);
+            }
+        }
+
+        QList<Value> added;
+        int lastColumn = this->columnCount() - 1;
+        for (const Value &value : delta.updated) {
+            auto it = rowOf.constFind(value.*keyMember);
+            if (it == rowOf.constEnd()) {
+                added.append(value);
+                continue;
+            }
+            int row = it.value();
+            rows[row] = value;
+            emit this->dataChanged(this->index(row, 0), this->index(row, lastColumn));
+        }
+        if (!added.isEmpty()) {
+            int first = rows.size();
+            this->beginInsertRows(QModelIndex(), first, first + added.size() - 1);
+            for (const Value &value : added) {
+                rowOf.insert(value.*keyMember, rows.size());
+                rows.append(value);
+            }
+            this->endInsertRows();
+        }
+    }
 };
 
+/**
+ * @brief Sort and filter proxy for AddressableItemModel
+ *
+ * Subclasses can provide sort and filter keys for the top level rows of the source model. The
+ * keys are extracted once per row and cached until the row changes, so sorting compares
+ * precomputed values instead of looking them up for every comparison.
+ *
+ * With setFilterIndexEnabled(), the filter keys of large models are indexed by trigrams in the
+ * background, so filterKeyContains() only verifies the rows the index returns. The matches of
+ * the last filter are kept as well, a filter extending it only verifies the previous matches.
+ */
 class CUTTER_EXPORT AddressableFilterProxyModel : public AddressableItemModel<QSortFilterProxyModel>
 {
     using ParentClass = AddressableItemModel<QSortFilterProxyModel>;
 
 public:
     AddressableFilterProxyModel(AddressableItemModelI *sourceModel, QObject *parent);
+    ~AddressableFilterProxyModel() override;
 
     RVA address(const QModelIndex &index) const override;
     QString name(const QModelIndex &) const override;
     void setSourceModel(AddressableItemModelI *sourceModel);
 
+protected:
+    /**
+     * @brief Precomputed value of a row, numbers are compared first, then texts
+     */
+    struct SortKey
+    {
+        quint64 number = 0;
+        QString text;
+
+        bool operator<(const SortKey &other) const
+        {
+            return number != other.number ? number < other.number : text < other.text;
+        }
+    };
+
+    /**
+     * @brief Extract the key of the top level \a sourceRow for sorting by \a column
+     *
+     * The default implementation provides the comment at the address of the row for the column
+     * set with setCommentColumn().
+     * @return false to compare the rows with lessThan() of the subclass
+     */
+    virtual bool sortKey(int sourceRow, int column, SortKey &key) const;
+    /**
+     * @brief Compare the cached sort keys if sortKey() provides them for the column
+     *
+     * Subclasses overriding this call it for the columns they provide keys for.
+     */
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+    /**
+     * @brief Sort \a column by the comments at the addresses of the rows
+     */
+    void setCommentColumn(int column) { commentColumn = column; }
+
+    /**
+     * @brief Text of the top level \a sourceRow matched by filterKeyContains()
+     */
+    virtual QString filterKey(int sourceRow) const;
+    /**
+     * @return whether the filter matches filterKey() of \a sourceRow. Filters without special
+     * characters are searched in cached keys, lowercase for case insensitive filters.
+     */
+    bool filterKeyContains(int sourceRow) const;
+    /**
+     * @brief Index filterKey() of all rows in the background once the model has
+     * FILTER_INDEX_MIN_ROWS rows, for filters used with filterKeyContains()
+     */
+    void setFilterIndexEnabled(bool enabled);
+
+    /// Smaller models are searched without an index
+    static constexpr int FILTER_INDEX_MIN_ROWS = 10000;
+
 private:
     void setSourceModel(QAbstractItemModel *sourceModel) override; // Don't use this directly
+
+    /**
+     * @brief Values computed for the top level source rows, kept in sync with row changes
+     */
+    template<typename T>
+    struct RowCache
+    {
+        QVector<T> values;
+        QVector<bool> ready;
+
+        void clear()
+        {
+            values.clear();
+            ready.clear();
+        }
+        void resize(int rows)
+        {
+            values.resize(rows);
+            ready.resize(rows);
+        }
+        void insertRows(int first, int count)
+        {
+            if (first <= values.size()) {
+                values.insert(first, count, T());
+                ready.insert(first, count, false);
+            }
+        }
+        void removeRows(int first, int count)
+        {
+            count = std::min(count, static_cast<int>(values.size()) - first);
+            if (count > 0) {
+                values.remove(first, count);
+                ready.remove(first, count);
+            }
+        }
+        void invalidateRows(int first, int last)
+        {
+            for (int i = std::max(first, 0); i <= last && i < ready.size(); i++) {
+                ready[i] = false;
+            }
+        }
+    };
+
+    void connectSourceModel(QAbstractItemModel *model);
+    void clearCaches();
+
+    bool keyContains(int sourceRow, const QString &needle, bool lower) const;
+    /**
+     * @brief Compute filterMatches for \a pattern, using the index and the previous matches
+     */
+    void updateFilterMatches(const QString &pattern, bool lower) const;
+
+    void resetFilterIndex();
+    void scheduleFilterIndexUpdate();
+    /**
+     * @brief Start indexing the rows which are not in the index yet
+     */
+    void updateFilterIndex();
+
+    struct CachedSortKey
+    {
+        SortKey key;
+        bool hasKey = false;
+    };
+    CachedSortKey cachedSortKey(int sourceRow, int column) const;
+
     AddressableItemModelI *addressableSourceModel;
+    QList<QMetaObject::Connection> sourceConnections;
+    int commentColumn = -1;
+    /// Column of sortKeys
+    mutable int sortKeysColumn = -1;
+    mutable RowCache<CachedSortKey> sortKeys;
+    mutable RowCache<QString> filterKeys;
+    /// Whether filterKeys are lowercase
+    mutable bool filterKeysLower = false;
+
+    /// Whether each row matches matchesPattern, rows not ready have to be verified
+    mutable RowCache<bool> filterMatches;
+    mutable QString matchesPattern;
+    /// matchesPattern as searched in filterKeys, lowercase if matchesLower
+    mutable QString matchesNeedle;
+    mutable bool matchesLower = false;
+
+    bool filterIndexEnabled = false;
+    bool filterIndexUpdatePending = false;
+    /// Index of the first rows of filterIndexTexts, nullptr while filterIndexTask extends it
+    std::unique_ptr<TrigramIndex> filterIndex;
+    /// Keys of the indexed rows, to notice changes
+    QVector<QString> filterIndexTexts;
+    QSharedPointer<TrigramIndexTask> filterIndexTask;
+    quint64 filterIndexTaskId = 0;
 };
 
 #endif // ADDRESSABLEITEMMODEL_H
@@ -0,0 +1,286 @@
+#include "BatchDecompiler.h"
+
+#include "core/Cutter.h"
+#include "common/AnalysisTask.h"
+#include "common/Configuration.h"
+#include "common/DecompilationCache.h"
+#include "common/Decompiler.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRunnable>
+#include <QThread>
+#include <QTimer>
+
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+const char *annotationTypeName(RzCodeAnnotationType type)
+{
+    switch (type) {
+    case RZ_CODE_ANNOTATION_TYPE_OFFSET:
+        return "offset";
+    case RZ_CODE_ANNOTATION_TYPE_SYNTAX_HIGHLIGHT:
+        return "syntax_highlight";
+    case RZ_CODE_ANNOTATION_TYPE_FUNCTION_NAME:
+        return "function_name";
+    case RZ_CODE_ANNOTATION_TYPE_GLOBAL_VARIABLE:
+        return "global_variable";
+    case RZ_CODE_ANNOTATION_TYPE_CONSTANT_VARIABLE:
+        return "constant_variable";
+    case RZ_CODE_ANNOTATION_TYPE_LOCAL_VARIABLE:
+        return "local_variable";
+    case RZ_CODE_ANNOTATION_TYPE_FUNCTION_PARAMETER:
+        return "function_parameter";
+    default:
+        return "unknown";
+    }
+}
+
+QJsonArray annotationsToJson(const RzAnnotatedCode &code)
+{
+    QJsonArray annotations;
+    void *iter;
+    rz_vector_foreach(&code.annotations, iter)
+    {
+        auto annotation = static_cast<const RzCodeAnnotation *>(iter);
+        QJsonObject json;
+        json["start"] = static_cast<qint64>(annotation->start);
+        json["end"] = static_cast<qint64>(annotation->end);
+        json["type"] = QString::fromLatin1(annotationTypeName(annotation->type));
+        switch (annotation->type) {
+        case RZ_CODE_ANNOTATION_TYPE_OFFSET:
+            json["offset"] = RzAddressString(annotation->offset.offset);
+            break;
+        case RZ_CODE_ANNOTATION_TYPE_SYNTAX_HIGHLIGHT:
+            json["syntax_highlight"] = static_cast<int>(annotation->syntax_highlight.type);
+            break;
+        case RZ_CODE_ANNOTATION_TYPE_FUNCTION_NAME:
+            json["name"] = QString::fromUtf8(annotation->reference.name);
+            json["offset"] = RzAddressString(annotation->reference.offset);
+            break;
+        case RZ_CODE_ANNOTATION_TYPE_GLOBAL_VARIABLE:
+        case RZ_CODE_ANNOTATION_TYPE_CONSTANT_VARIABLE:
+            json["offset"] = RzAddressString(annotation->reference.offset);
+            break;
+        case RZ_CODE_ANNOTATION_TYPE_LOCAL_VARIABLE:
+        case RZ_CODE_ANNOTATION_TYPE_FUNCTION_PARAMETER:
+            json["name"] = QString::fromUtf8(annotation->variable.name);
+            break;
+        default:
+            break;
+        }
+        annotations.append(json);
+    }
+    return annotations;
+}
+
+/**
+ * @brief Converts the decompiled code of one function to JSON and writes it, on a worker thread
+ */
+class FunctionWriter : public QRunnable
+{
+public:
+    FunctionWriter(RzAnnotatedCode *code, QJsonObject function, QString path, QAtomicInt *errors)
+        : code(code, &rz_annotated_code_free),
+          function(std::move(function)),
+          path(std::move(path)),
+          errors(errors)
+    {
+    }
+
+    void run() override
+    {
+        QJsonObject root = function;
+        root["code"] = QString::fromUtf8(code->code);
+        root["annotations"] = annotationsToJson(*code);
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly)
+            || file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) < 0) {
+            qWarning() << "Cannot write" << path << file.errorString();
+            errors->ref();
+        }
+    }
+
+private:
+    std::unique_ptr<RzAnnotatedCode, decltype(&rz_annotated_code_free)> code;
+    QJsonObject function;
+    QString path;
+    QAtomicInt *errors;
+};
+
+} // namespace
+
+BatchDecompiler::BatchDecompiler(const InitialOptions &options, const QString &outputDir,
+                                 const QString &decompilerId, int workers, QObject *parent)
+    : QObject(parent), options(options), outputDir(outputDir), decompilerId(decompilerId)
+{
+    writers.setMaxThreadCount(workers > 0 ? workers : QThread::idealThreadCount());
+}
+
+BatchDecompiler::~BatchDecompiler()
+{
+    if (runningRequest && decompiler) {
+        decompiler->cancelRequest(runningRequest);
+    }
+    writers.waitForDone();
+}
+
+void BatchDecompiler::start()
+{
+    if (!outputDir.mkpath(".")) {
+        fail(tr("Cannot create the output directory %1.").arg(outputDir.path()));
+        return;
+    }
+
+    QString id = decompilerId.isEmpty() ? Config()->getSelectedDecompiler() : decompilerId;
+    decompiler = Core()->getDecompilerById(id);
+    if (!decompiler && decompilerId.isEmpty() && !Core()->getDecompilers().isEmpty()) {
+        decompiler = Core()->getDecompilers().first();
+    }
+    if (!decompiler) {
+        fail(decompilerId.isEmpty() ? tr("No decompiler is available.")
+                                    : tr("Unknown decompiler %1.").arg(decompilerId));
+        return;
+    }
+    connect(decompiler, &Decompiler::requestFinished, this,
+            &BatchDecompiler::decompilationFinished);
+
+    auto task = new AnalysisTask();
+    task->setOptions(options);
+    analysisTask = AsyncTask::Ptr(task);
+    connect(task, &AsyncTask::logChanged, this, [](const QString &log) {
+        QString line = log.trimmed().section(QLatin1Char('\n'), -1);
+        if (!line.isEmpty()) {
+            printf("%s\n", line.toLocal8Bit().constData());
+            fflush(stdout);
+        }
+    });
+    connect(task, &AsyncTask::finished, this, &BatchDecompiler::analysisFinished);
+    Core()->getAsyncTaskManager()->start(analysisTask);
+}
+
+void BatchDecompiler::analysisFinished()
+{
+    auto task = static_cast<AnalysisTask *>(analysisTask.data());
+    qint64 analysisTimeMs = task->getElapsedTime();
+    bool openFailed = task->getOpenFileFailed();
+    analysisTask.clear();
+    if (openFailed) {
+        fail(tr("Cannot open the file %1.").arg(options.filename));
+        return;
+    }
+
+    functions = Core()->getAllFunctions();
+    printf("%s\n",
+           tr("Analysis took %1 s, decompiling %2 functions with %3")
+                   .arg(analysisTimeMs / 1000.0, 0, 'f', 1)
+                   .arg(functions.size())
+                   .arg(decompiler->getName())
+                   .toLocal8Bit()
+                   .constData());
+    fflush(stdout);
+    current = -1;
+    totalTimer.start();
+    decompileNext();
+}
+
+void BatchDecompiler::decompileNext()
+{
+    current++;
+    if (current >= functions.size()) {
+        finish();
+        return;
+    }
+    if (!decompiler) {
+        fail(tr("The decompiler has been removed."));
+        return;
+    }
+    functionTimer.start();
+    runningRequest = decompiler->requestDecompilation(functions[current].offset);
+}
+
+void BatchDecompiler::decompilationFinished(quint64 requestId, RzAnnotatedCode *code)
+{
+    if (!runningRequest || requestId != runningRequest) {
+        return;
+    }
+    runningRequest = 0;
+    qint64 elapsed = functionTimer.elapsed();
+    decompileTimeMs += elapsed;
+
+    const FunctionDescription &function = functions[current];
+    QJsonObject entry;
+    entry["name"] = function.name;
+    entry["offset"] = RzAddressString(function.offset);
+    entry["time_ms"] = elapsed;
+
+    bool decompiled = code && !RZ_STR_ISEMPTY(code->code);
+    if (decompiled) {
+        QString fileName = RzAddressString(function.offset) + ".json";
+        entry["file"] = fileName;
+        // The code is owned by the decompiler, the writer gets a copy
+        writers.start(new FunctionWriter(DecompilationCache::copyCode(*code), entry,
+                                         outputDir.filePath(fileName), &writeErrors));
+    } else {
+        failedFunctions++;
+    }
+    entry["decompiled"] = decompiled;
+    index.append(entry);
+
+    printf("[%d/%d] %s %s %lld ms%s\n", current + 1, static_cast<int>(functions.size()),
+           RzAddressString(function.offset).toLocal8Bit().constData(),
+           function.name.toLocal8Bit().constData(), static_cast<long long>(elapsed),
+           decompiled ? "" : " (failed)");
+    fflush(stdout);
+
+    // The decompiler may still consider itself running while emitting its result
+    QTimer::singleShot(0, this, &BatchDecompiler::decompileNext);
+}
+
+void BatchDecompiler::finish()
+{
+    writers.waitForDone();
+    qint64 totalTimeMs = totalTimer.elapsed();
+    double seconds = totalTimeMs / 1000.0;
+    double throughput = seconds > 0 ? functions.size() / seconds : 0;
+
+    QJsonObject root;
+    root["file"] = options.filename;
+    root["decompiler"] = decompiler ? decompiler->getId() : decompilerId;
+    root["functions"] = index;
+    root["total_time_ms"] = totalTimeMs;
+    root["decompile_time_ms"] = decompileTimeMs;
+    root["functions_per_second"] = throughput;
+
+    QFile indexFile(outputDir.filePath("index.json"));
+    if (!indexFile.open(QIODevice::WriteOnly)
+        || indexFile.write(QJsonDocument(root).toJson()) < 0) {
+        fail(tr("Cannot write %1: %2").arg(indexFile.fileName(), indexFile.errorString()));
+        return;
+    }
+    indexFile.close();
+
+    int errors = writeErrors.loadAcquire();
+    printf("%s\n",
+           tr("Decompiled %1 functions in %2 s (%3 functions/s), %4 failed, %5 not written")
+                   .arg(functions.size())
+                   .arg(seconds, 0, 'f', 1)
+                   .arg(throughput, 0, 'f', 2)
+                   .arg(failedFunctions)
+                   .arg(errors)
+                   .toLocal8Bit()
+                   .constData());
+    fflush(stdout);
+    emit finished(failedFunctions == 0 && errors == 0 ? 0 : 1);
+}
+
+void BatchDecompiler::fail(const QString &message)
+{
+    fprintf(stderr, "%s\n", message.toLocal8Bit().constData());
+    emit finished(1);
+}
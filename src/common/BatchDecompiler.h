@@ -0,0 +1,86 @@
+#ifndef BATCHDECOMPILER_H
+#define BATCHDECOMPILER_H
+
+#include "core/CutterCommon.h"
+#include "core/CutterDescriptions.h"
+#include "common/AsyncTask.h"
+#include "common/InitialOptions.h"
+
+#include <rz_util/rz_annotated_code.h>
+
+#include <QAtomicInt>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QThreadPool>
+
+class Decompiler;
+
+/**
+ * @brief Headless mode decompiling all functions of a file into a directory.
+ *
+ * The file is loaded and analyzed according to the InitialOptions, then every function is
+ * decompiled with one decompiler. Each result is written to \<offset\>.json in the output
+ * directory, holding the code and its annotations, and index.json lists all functions with their
+ * output file and decompilation time. Progress and the overall throughput are printed to stdout.
+ *
+ * Decompilers work on the shared core, so only one function is decompiled at a time. Converting
+ * and writing the results is done by a pool of worker threads in the meantime.
+ */
+class CUTTER_EXPORT BatchDecompiler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param decompilerId id of the decompiler to use, empty for the one selected in the settings
+     * @param workers number of threads writing the results, 0 for one per core
+     */
+    BatchDecompiler(const InitialOptions &options, const QString &outputDir,
+                    const QString &decompilerId, int workers, QObject *parent = nullptr);
+    ~BatchDecompiler();
+
+    /**
+     * @brief Load and analyze the file, then decompile all functions. finished() is emitted at
+     * the end.
+     */
+    void start();
+
+signals:
+    /**
+     * @param exitCode 0 if all functions were decompiled and written, 1 otherwise
+     */
+    void finished(int exitCode);
+
+private slots:
+    void analysisFinished();
+    void decompilationFinished(quint64 requestId, RzAnnotatedCode *code);
+
+private:
+    void decompileNext();
+    void finish();
+    void fail(const QString &message);
+
+    InitialOptions options;
+    QDir outputDir;
+    QString decompilerId;
+    QPointer<Decompiler> decompiler;
+    AsyncTask::Ptr analysisTask;
+    QThreadPool writers;
+
+    QList<FunctionDescription> functions;
+    /// Index in functions of the function being decompiled
+    int current = -1;
+    quint64 runningRequest = 0;
+    QElapsedTimer functionTimer;
+    QElapsedTimer totalTimer;
+    qint64 decompileTimeMs = 0;
+    QJsonArray index;
+    int failedFunctions = 0;
+    QAtomicInt writeErrors;
+};
+
+#endif // BATCHDECOMPILER_H
@@ -150,6 +150,9 @@ Configuration::Configuration() : QObject(), nativePalette(qApp->palette())
 #ifdef CUTTER_ENABLE_KSYNTAXHIGHLIGHTING
     kSyntaxHighlightingRepository = nullptr;
 #endif
+    rebuildColorPalette();
+    // Connected before any widget, so the palette is up to date in their colorsUpdated slots
+    connect(this, &Configuration::colorsUpdated, this, &Configuration::rebuildColorPalette);
 }
 
 Configuration *Configuration::instance()
@@ -508,6 +511,11 @@ QString Configuration::getLogoFile()
 void Configuration::setColor(const QString &name, const QColor &color)
 {
     s.setValue("colors." + name, color);
+    colorPalette.insert(name, color);
+    if (name == "other") {
+        fallbackColor = color;
+    }
+    colorPaletteGeneration++;
 }
 
 void Configuration::setLastThemeOf(const CutterInterfaceTheme &currInterfaceTheme,
@@ -516,13 +524,26 @@ void Configuration::setLastThemeOf(const CutterInterfaceTheme &currInterfaceThem
     s.setValue("lastThemeOf." + currInterfaceTheme.name, theme);
 }
 
-const QColor Configuration::getColor(const QString &name) const
+const QColor Configuration::getColor(const ColorKey &key) const
 {
-    if (s.contains("colors." + name)) {
-        return s.value("colors." + name).value<QColor>();
-    } else {
-        return s.value("colors.other").value<QColor>();
+    auto it = colorPalette.constFind(key);
+    return it != colorPalette.constEnd() ? it.value() : fallbackColor;
+}
+
+/**
+ * @brief Reload all colors from the settings into the in-memory palette
+ */
+void Configuration::rebuildColorPalette()
+{
+    const QString prefix = QStringLiteral("colors.");
+    colorPalette.clear();
+    for (const QString &key : s.allKeys()) {
+        if (key.startsWith(prefix)) {
+            colorPalette.insert(key.mid(prefix.size()), s.value(key).value<QColor>());
+        }
     }
+    fallbackColor = colorPalette.value(QStringLiteral("other"));
+    colorPaletteGeneration++;
 }
 
 void Configuration::setColorTheme(const QString &theme)
@@ -716,6 +737,36 @@ void Configuration::setDecompilerAutoRefreshEnabled(bool enabled)
     s.setValue("decompilerAutoRefresh", enabled);
 }
 
+int Configuration::getDecompilerPrefetchLimit()
+{
+    return s.value("decompilerPrefetchLimit", 8).toInt();
+}
+
+void Configuration::setDecompilerPrefetchLimit(int functions)
+{
+    s.setValue("decompilerPrefetchLimit", functions);
+}
+
+int Configuration::getDecompilerPrefetchTimeBudget()
+{
+    return s.value("decompilerPrefetchTimeBudget", 120).toInt();
+}
+
+void Configuration::setDecompilerPrefetchTimeBudget(int seconds)
+{
+    s.setValue("decompilerPrefetchTimeBudget", seconds);
+}
+
+int Configuration::getDecompilerPrefetchCpuShare()
+{
+    return s.value("decompilerPrefetchCpuShare", 50).toInt();
+}
+
+void Configuration::setDecompilerPrefetchCpuShare(int percent)
+{
+    s.setValue("decompilerPrefetchCpuShare", percent);
+}
+
 void Configuration::enableDecompilerAnnotationHighlighter(bool useDecompilerHighlighter)
 {
     s.setValue("decompilerAnnotationHighlighter", useDecompilerHighlighter);
@@ -840,3 +891,13 @@ void Configuration::setFunctionsWidgetLayout(const QString &layout)
 {
     s.setValue("functionsWidgetLayout", layout);
 }
+
+int Configuration::getStringsChunkSize()
+{
+    return s.value("stringsChunkSize", 10000).toInt();
+}
+
+void Configuration::setStringsChunkSize(int strings)
+{
+    s.setValue("stringsChunkSize", strings);
+}
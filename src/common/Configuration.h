@@ -3,6 +3,7 @@
 
 #include <QSettings>
 #include <QFont>
+#include <QHash>
 #include <core/Cutter.h>
 
 #define Config() (Configuration::instance())
@@ -15,6 +16,40 @@ class Theme;
 }
 #endif
 
+/**
+ * @brief Name of a color option together with its precomputed hash
+ *
+ * Implicitly constructible from a string, so ConfigColor("name") keeps working. Paint code
+ * looking up the same colors over and over can keep a static ColorKey to skip converting and
+ * hashing the name on every lookup.
+ */
+class CUTTER_EXPORT ColorKey
+{
+public:
+    ColorKey(const QString &name) : name(name), hash(qHash(name)) {}
+    ColorKey(const char *name) : ColorKey(QString::fromUtf8(name)) {}
+
+    const QString &getName() const { return name; }
+    bool operator==(const ColorKey &other) const
+    {
+        return hash == other.hash && name == other.name;
+    }
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    friend uint qHash(const ColorKey &key, uint seed = 0) { return key.hash ^ seed; }
+#else
+    friend size_t qHash(const ColorKey &key, size_t seed = 0) { return key.hash ^ seed; }
+#endif
+
+private:
+    QString name;
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    uint hash;
+#else
+    size_t hash;
+#endif
+};
+
 class QSyntaxHighlighter;
 class QTextDocument;
 
@@ -37,6 +72,14 @@ private:
     QSettings s;
     static Configuration *mPtr;
 
+    /**
+     * @brief Colors of the current theme, kept in sync with the "colors.*" settings
+     */
+    QHash<ColorKey, QColor> colorPalette;
+    QColor fallbackColor;
+    quint64 colorPaletteGeneration = 0;
+    void rebuildColorPalette();
+
 #ifdef CUTTER_ENABLE_KSYNTAXHIGHLIGHTING
     KSyntaxHighlighting::Repository *kSyntaxHighlightingRepository;
 #endif
@@ -131,7 +174,18 @@ public:
     int colorThemeDarkness(const QString &colorTheme) const;
 
     void setColor(const QString &name, const QColor &color);
-    const QColor getColor(const QString &name) const;
+    /**
+     * @brief Get a color of the current theme from the in-memory palette
+     *
+     * Falls back to the "other" color for unknown names, like the settings did.
+     */
+    const QColor getColor(const ColorKey &key) const;
+    /**
+     * @brief Counter which changes whenever any color of the palette changes
+     *
+     * Lets code caching values derived from colors detect that they are outdated.
+     */
+    quint64 getColorPaletteGeneration() const { return colorPaletteGeneration; }
 
     /**
      * @brief Get the value of a config var either from Rizin or settings, depending on the key.
@@ -156,6 +210,23 @@ public:
     bool getDecompilerAutoRefreshEnabled();
     void setDecompilerAutoRefreshEnabled(bool enabled);
 
+    /**
+     * @return how many neighbors of a shown function get decompiled in the background, 0 disables
+     * it (see DecompilerPrefetcher)
+     */
+    int getDecompilerPrefetchLimit();
+    void setDecompilerPrefetchLimit(int functions);
+    /**
+     * @return seconds after showing a function during which neighbors may get decompiled
+     */
+    int getDecompilerPrefetchTimeBudget();
+    void setDecompilerPrefetchTimeBudget(int seconds);
+    /**
+     * @return percentage of time the decompiler may be busy with background work
+     */
+    int getDecompilerPrefetchCpuShare();
+    void setDecompilerPrefetchCpuShare(int percent);
+
     void enableDecompilerAnnotationHighlighter(bool useDecompilerHighlighter);
     bool isDecompilerAnnotationHighlighterEnabled();
 
@@ -167,6 +238,24 @@ public:
 
     void setGraphMinFontSize(int sz) { s.setValue("graph.minfontsize", sz); }
 
+    /**
+     * @brief Zoom level in percent below which graph blocks are drawn as plain rectangles
+     */
+    int getGraphSimplifiedBlockZoom() const { return s.value("graph.lod.blockzoom", 25).toInt(); }
+    void setGraphSimplifiedBlockZoom(int zoom) { s.setValue("graph.lod.blockzoom", zoom); }
+
+    /**
+     * @brief Zoom level in percent below which graph edges are drawn as straight lines
+     */
+    int getGraphSimplifiedEdgeZoom() const { return s.value("graph.lod.edgezoom", 10).toInt(); }
+    void setGraphSimplifiedEdgeZoom(int zoom) { s.setValue("graph.lod.edgezoom", zoom); }
+
+    /**
+     * @brief Whether simplified graph blocks show their address when it fits
+     */
+    bool getGraphSimplifiedBlockTitle() const { return s.value("graph.lod.title", true).toBool(); }
+    void setGraphSimplifiedBlockTitle(bool enabled) { s.setValue("graph.lod.title", enabled); }
+
     /**
      * @brief Get the boolean setting for preview in Graph
      * @return True if preview checkbox is checked, false otherwise
@@ -247,6 +336,12 @@ public:
      * @param layout The layout of the Functions widget, either horizontal or vertical.
      */
     void setFunctionsWidgetLayout(const QString &layout);
+
+    /**
+     * @return number of strings the Strings widget receives at once while they are being loaded
+     */
+    int getStringsChunkSize();
+    void setStringsChunkSize(int strings);
 public slots:
     void refreshFont();
 signals:
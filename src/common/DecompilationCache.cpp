@@ -0,0 +1,121 @@
+#include "DecompilationCache.h"
+
+#include <QMutexLocker>
+
+#include <cstring>
+
+DecompilationCache::DecompilationCache(size_t maxBytes) : maxBytes(maxBytes) {}
+
+RzAnnotatedCode *DecompilationCache::find(const QString &decompilerId, RVA function,
+                                          quint64 generation)
+{
+    QMutexLocker locker(&mutex);
+    auto it = entries.find(Key(decompilerId, function, generation));
+    if (it == entries.end()) {
+        return nullptr;
+    }
+    lru.splice(lru.begin(), lru, it->second.lruPos);
+    return copyCode(*it->second.code);
+}
+
+bool DecompilationCache::contains(const QString &decompilerId, RVA function, quint64 generation)
+{
+    QMutexLocker locker(&mutex);
+    return entries.find(Key(decompilerId, function, generation)) != entries.end();
+}
+
+void DecompilationCache::insert(const QString &decompilerId, RVA function, quint64 generation,
+                                const RzAnnotatedCode &code)
+{
+    QMutexLocker locker(&mutex);
+    if (generation < latestGeneration) {
+        // The analysis changed while decompiling
+        return;
+    }
+    if (generation > latestGeneration) {
+        entries.clear();
+        lru.clear();
+        usedBytes = 0;
+        latestGeneration = generation;
+    }
+
+    CodePtr copy(copyCode(code), &rz_annotated_code_free);
+    if (!copy) {
+        return;
+    }
+    Key key(decompilerId, function, generation);
+    auto old = entries.find(key);
+    if (old != entries.end()) {
+        remove(old);
+    }
+
+    size_t bytes = estimateBytes(*copy);
+    lru.push_front(key);
+    Entry entry { std::move(copy), bytes, lru.begin() };
+    entries.emplace(key, std::move(entry));
+    usedBytes += bytes;
+
+    while (usedBytes > maxBytes && !lru.empty()) {
+        remove(entries.find(lru.back()));
+    }
+}
+
+void DecompilationCache::invalidate()
+{
+    QMutexLocker locker(&mutex);
+    entries.clear();
+    lru.clear();
+    usedBytes = 0;
+}
+
+RzAnnotatedCode *DecompilationCache::copyCode(const RzAnnotatedCode &code)
+{
+    RzAnnotatedCode *result = rz_annotated_code_new(strdup(code.code ? code.code : ""));
+    if (!result) {
+        return nullptr;
+    }
+    void *iter;
+    rz_vector_foreach(&code.annotations, iter)
+    {
+        RzCodeAnnotation annotation = *static_cast<RzCodeAnnotation *>(iter);
+        // Same strings as freed by rz_annotation_free
+        switch (annotation.type) {
+        case RZ_CODE_ANNOTATION_TYPE_FUNCTION_NAME:
+            annotation.reference.name =
+                    annotation.reference.name ? strdup(annotation.reference.name) : nullptr;
+            break;
+        case RZ_CODE_ANNOTATION_TYPE_LOCAL_VARIABLE:
+        case RZ_CODE_ANNOTATION_TYPE_FUNCTION_PARAMETER:
+            annotation.variable.name =
+                    annotation.variable.name ? strdup(annotation.variable.name) : nullptr;
+            break;
+        default:
+            break;
+        }
+        rz_annotated_code_add_annotation(result, &annotation);
+    }
+    return result;
+}
+
+void DecompilationCache::remove(std::map<Key, Entry>::iterator it)
+{
+    usedBytes -= it->second.bytes;
+    lru.erase(it->second.lruPos);
+    entries.erase(it);
+}
+
+size_t DecompilationCache::estimateBytes(const RzAnnotatedCode &code)
+{
+    size_t bytes = sizeof(Entry) + sizeof(Key) * 2 + (code.code ? strlen(code.code) : 0);
+    void *iter;
+    rz_vector_foreach(&code.annotations, iter)
+    {
+        auto annotation = static_cast<const RzCodeAnnotation *>(iter);
+        bytes += sizeof(RzCodeAnnotation);
+        if (annotation->type == RZ_CODE_ANNOTATION_TYPE_FUNCTION_NAME
+            && annotation->reference.name) {
+            bytes += strlen(annotation->reference.name);
+        }
+    }
+    return bytes;
+}
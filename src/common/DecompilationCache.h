@@ -0,0 +1,69 @@
+#ifndef DECOMPILATIONCACHE_H
+#define DECOMPILATIONCACHE_H
+
+#include "core/CutterCommon.h"
+
+#include <rz_util/rz_annotated_code.h>
+
+#include <QMutex>
+#include <QString>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <tuple>
+
+/**
+ * @brief Recently decompiled code, shared by all decompiler widgets.
+ *
+ * Code is stored together with the analysis generation of CutterCore at the time the
+ * decompilation was started. Lookups only return code of the requested generation, so nothing
+ * computed before a rename, a type change or similar is shown. Inserting code of a newer
+ * generation drops everything older. Entries are evicted in LRU order once their estimated size
+ * exceeds the budget.
+ */
+class CUTTER_EXPORT DecompilationCache
+{
+public:
+    explicit DecompilationCache(size_t maxBytes);
+
+    /**
+     * @return a copy of the cached code owned by the caller, nullptr if there is none
+     */
+    RzAnnotatedCode *find(const QString &decompilerId, RVA function, quint64 generation);
+    bool contains(const QString &decompilerId, RVA function, quint64 generation);
+    /**
+     * @brief Store a copy of \a code, which stays owned by the caller
+     */
+    void insert(const QString &decompilerId, RVA function, quint64 generation,
+                const RzAnnotatedCode &code);
+    void invalidate();
+
+    /**
+     * @brief Deep copy of the code and all its annotations
+     */
+    static RzAnnotatedCode *copyCode(const RzAnnotatedCode &code);
+
+private:
+    using Key = std::tuple<QString, RVA, quint64>;
+    using CodePtr = std::unique_ptr<RzAnnotatedCode, decltype(&rz_annotated_code_free)>;
+
+    struct Entry
+    {
+        CodePtr code;
+        size_t bytes;
+        std::list<Key>::iterator lruPos;
+    };
+
+    void remove(std::map<Key, Entry>::iterator it);
+    static size_t estimateBytes(const RzAnnotatedCode &code);
+
+    QMutex mutex;
+    std::map<Key, Entry> entries;
+    std::list<Key> lru; ///< Most recently used first
+    size_t usedBytes = 0;
+    size_t maxBytes;
+    quint64 latestGeneration = 0;
+};
+
+#endif // DECOMPILATIONCACHE_H
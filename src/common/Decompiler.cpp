@@ -1,13 +1,17 @@
-
 #include "Decompiler.h"
 #include "Cutter.h"
 
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QTimer>
+
+#include <atomic>
+#include <memory>
 
 Decompiler::Decompiler(const QString &id, const QString &name, QObject *parent)
-    : QObject(parent), id(id), name(name)
+    : QObject(parent), id(id), name(name), finishedCode(nullptr, &rz_annotated_code_free)
 {
+    connect(this, &Decompiler::finished, this, &Decompiler::decompilationFinished);
 }
 
 RzAnnotatedCode *Decompiler::makeWarning(QString warningMessage)
@@ -15,3 +19,66 @@ RzAnnotatedCode *Decompiler::makeWarning(QString warningMessage)
     std::string temporary = warningMessage.toStdString();
     return rz_annotated_code_new(strdup(temporary.c_str()));
 }
+
+quint64 Decompiler::requestDecompilation(RVA addr)
+{
+    static std::atomic<quint64> lastRequest { 0 };
+    quint64 request = ++lastRequest;
+
+    if (pendingRequest) {
+        emit requestFinished(pendingRequest, nullptr);
+    }
+    pendingRequest = request;
+    pendingAddr = addr;
+    if (runningRequest) {
+        // Started once the canceled decompilation has finished
+        if (!runningCanceled) {
+            runningCanceled = true;
+            cancel();
+        }
+    } else {
+        startPendingRequest();
+    }
+    return request;
+}
+
+void Decompiler::cancelRequest(quint64 requestId)
+{
+    if (requestId == pendingRequest) {
+        pendingRequest = 0;
+        emit requestFinished(requestId, nullptr);
+    } else if (requestId == runningRequest && !runningCanceled) {
+        runningCanceled = true;
+        cancel();
+    }
+}
+
+void Decompiler::startPendingRequest()
+{
+    if (!pendingRequest || runningRequest) {
+        return;
+    }
+    runningRequest = pendingRequest;
+    runningCanceled = false;
+    pendingRequest = 0;
+    decompileAt(pendingAddr);
+}
+
+void Decompiler::decompilationFinished(RzAnnotatedCode *codeDecompiled)
+{
+    // Kept until the next result, so all receivers of finished() can still use it
+    if (codeDecompiled != finishedCode.get()) {
+        finishedCode.reset(codeDecompiled);
+    }
+    quint64 request = runningRequest;
+    bool canceled = runningCanceled;
+    runningRequest = 0;
+    runningCanceled = false;
+    if (request) {
+        emit requestFinished(request, canceled ? nullptr : codeDecompiled);
+    }
+    if (pendingRequest) {
+        // The implementation may still consider itself running during this signal
+        QTimer::singleShot(0, this, &Decompiler::startPendingRequest);
+    }
+}
@@ -8,8 +8,17 @@
 #include <QString>
 #include <QObject>
 
+#include <atomic>
+#include <memory>
+
 /**
  * Implements a decompiler that can be registered using CutterCore::registerDecompiler()
+ *
+ * Users call requestDecompilation(), only the latest request is served: a new request cancels
+ * the running one and drops its result. Implementations provide decompileAt() and emit
+ * finished() once for every decompileAt() call, also when it was canceled. They may override
+ * cancel() or poll isCancelRequested() to stop early, otherwise a canceled decompilation runs
+ * to its end and its result is dropped.
  */
 class CUTTER_EXPORT Decompiler : public QObject
 {
@@ -19,6 +28,17 @@ private:
     const QString id;
     const QString name;
 
+    quint64 runningRequest = 0;
+    std::atomic<bool> runningCanceled { false };
+    quint64 pendingRequest = 0;
+    RVA pendingAddr = RVA_INVALID;
+    std::unique_ptr<RzAnnotatedCode, decltype(&rz_annotated_code_free)> finishedCode;
+
+    void startPendingRequest();
+
+private slots:
+    void decompilationFinished(RzAnnotatedCode *codeDecompiled);
+
 public:
     Decompiler(const QString &id, const QString &name, QObject *parent = nullptr);
     virtual ~Decompiler() = default;
@@ -28,13 +48,57 @@ public:
     QString getId() const { return id; }
     QString getName() const { return name; }
     virtual bool isRunning() { return false; }
+    /**
+     * @return whether cancel() stops a running decompilation early
+     */
     virtual bool isCancelable() { return false; }
 
+    /**
+     * @brief Start decompiling, finished() must be emitted when done. Only called by
+     * requestDecompilation() while no other decompilation is running, use that instead.
+     */
     virtual void decompileAt(RVA addr) = 0;
+    /**
+     * @brief Stop the running decompilation as soon as possible. finished() must still be
+     * emitted, its result is dropped. The default implementation only makes
+     * isCancelRequested() return true.
+     */
     virtual void cancel() {}
 
+    /**
+     * @brief Decompile the function at \a addr, superseding all previous requests.
+     * @return id of the request, unique among all decompilers, passed back in requestFinished()
+     */
+    quint64 requestDecompilation(RVA addr);
+    /**
+     * @brief Drop request \a requestId, canceling the decompilation if it is running. Does nothing
+     * if it has been superseded already.
+     */
+    void cancelRequest(quint64 requestId);
+    /**
+     * @return whether a request is running or waiting for a canceled one to finish
+     */
+    bool hasRequests() const { return runningRequest || pendingRequest; }
+
+protected:
+    /**
+     * @return whether the running decompilation was canceled, may be called from any thread
+     */
+    bool isCancelRequested() const { return runningCanceled; }
+
 signals:
+    /**
+     * @brief Emitted by implementations when decompileAt() is done. The Decompiler owns
+     * \a codeDecompiled from then on and keeps it until the next decompilation finishes,
+     * receivers must not free it. Use requestFinished() instead.
+     */
     void finished(RzAnnotatedCode *codeDecompiled);
+    /**
+     * @brief Emitted once for every request.
+     * @param codeDecompiled the result, owned by the Decompiler like the one of finished().
+     * Receivers must copy it to keep it. nullptr if the request was superseded or canceled.
+     */
+    void requestFinished(quint64 requestId, RzAnnotatedCode *codeDecompiled);
 };
 
 #endif // DECOMPILER_H
@@ -0,0 +1,144 @@
+#include "DecompilerPrefetcher.h"
+
+#include "common/Configuration.h"
+#include "common/Decompiler.h"
+#include "core/Cutter.h"
+
+#include <QHash>
+#include <QSet>
+
+#include <algorithm>
+
+DecompilerPrefetcher::DecompilerPrefetcher(QObject *parent) : QObject(parent)
+{
+    startTimer.setSingleShot(true);
+    connect(&startTimer, &QTimer::timeout, this, &DecompilerPrefetcher::startNext);
+}
+
+DecompilerPrefetcher::~DecompilerPrefetcher()
+{
+    cancel();
+}
+
+void DecompilerPrefetcher::schedule(Decompiler *decompiler, RVA function)
+{
+    this->decompiler = decompiler;
+    remaining = Config()->getDecompilerPrefetchLimit();
+    candidates = remaining > 0 ? rankCandidates(function) : QList<RVA>();
+    budgetTimer.start();
+    if (!candidates.isEmpty() && !runningRequest) {
+        startTimer.start(IDLE_DELAY_MS);
+    }
+}
+
+void DecompilerPrefetcher::cancel()
+{
+    candidates.clear();
+    startTimer.stop();
+    quint64 request = runningRequest;
+    // Cleared first, canceling reports the request as finished
+    runningRequest = 0;
+    if (request && runningDecompiler) {
+        runningDecompiler->cancelRequest(request);
+    }
+}
+
+void DecompilerPrefetcher::startNext()
+{
+    if (runningRequest || !decompiler) {
+        return;
+    }
+    if (decompiler->hasRequests()) {
+        // Busy with a foreground decompilation, which will be followed by a new schedule call
+        return;
+    }
+    const qint64 budget = Config()->getDecompilerPrefetchTimeBudget() * 1000;
+    DecompilationCache *cache = Core()->getDecompilationCache();
+    quint64 generation = Core()->getAnalysisGeneration();
+    while (!candidates.isEmpty() && remaining > 0 && budgetTimer.elapsed() < budget) {
+        RVA function = candidates.takeFirst();
+        if (cache->contains(decompiler->getId(), function, generation)) {
+            continue;
+        }
+        remaining--;
+        runningDecompiler = decompiler;
+        runningFunction = function;
+        runningGeneration = generation;
+        runningTimer.start();
+        connect(decompiler, &Decompiler::requestFinished, this,
+                &DecompilerPrefetcher::decompilationFinished, Qt::UniqueConnection);
+        runningRequest = decompiler->requestDecompilation(function);
+        return;
+    }
+    candidates.clear();
+}
+
+void DecompilerPrefetcher::decompilationFinished(quint64 requestId, RzAnnotatedCode *code)
+{
+    if (!runningRequest || requestId != runningRequest) {
+        return;
+    }
+    // code is nullptr if a foreground request superseded this one
+    if (runningDecompiler && code && !RZ_STR_ISEMPTY(code->code)) {
+        Core()->getDecompilationCache()->insert(runningDecompiler->getId(), runningFunction,
+                                                runningGeneration, *code);
+    }
+    runningRequest = 0;
+    runningDecompiler = nullptr;
+    runningFunction = RVA_INVALID;
+
+    if (!candidates.isEmpty()) {
+        // Leave the decompiler idle for a while, so it only gets the configured share of time
+        int share = std::max(1, std::min(100, Config()->getDecompilerPrefetchCpuShare()));
+        qint64 pause = runningTimer.elapsed() * (100 - share) / share;
+        startTimer.start(static_cast<int>(std::min<qint64>(pause, 60 * 1000)));
+    }
+}
+
+QList<RVA> DecompilerPrefetcher::rankCandidates(RVA function)
+{
+    RzCoreLocked core(Core());
+    RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, function);
+    if (!fcn) {
+        return {};
+    }
+    auto isCandidate = [&](RzAnalysisFunction *other) {
+        return other && other->addr != function && other->type != RZ_ANALYSIS_FCN_TYPE_IMP;
+    };
+
+    // Callees first, functions called more often are more likely to be visited
+    QList<RVA> callees;
+    QHash<RVA, int> callCount;
+    auto xrefsFrom = fromOwned(rz_analysis_function_get_xrefs_from(fcn));
+    for (const auto &xref : CutterRzList<RzAnalysisXRef>(xrefsFrom.get())) {
+        if (xref->type != RZ_ANALYSIS_XREF_TYPE_CALL) {
+            continue;
+        }
+        RzAnalysisFunction *callee = rz_analysis_get_function_at(core->analysis, xref->to);
+        if (!isCandidate(callee)) {
+            continue;
+        }
+        if (!callCount.contains(callee->addr)) {
+            callees << callee->addr;
+        }
+        callCount[callee->addr]++;
+    }
+    std::stable_sort(callees.begin(), callees.end(),
+                     [&](RVA a, RVA b) { return callCount[a] > callCount[b]; });
+
+    QList<RVA> candidates = callees;
+    QSet<RVA> callers;
+    auto xrefsTo = fromOwned(rz_analysis_function_get_xrefs_to(fcn));
+    for (const auto &xref : CutterRzList<RzAnalysisXRef>(xrefsTo.get())) {
+        if (xref->type != RZ_ANALYSIS_XREF_TYPE_CALL) {
+            continue;
+        }
+        RzAnalysisFunction *caller = Core()->functionIn(xref->from);
+        if (isCandidate(caller) && !callCount.contains(caller->addr)
+            && !callers.contains(caller->addr)) {
+            callers.insert(caller->addr);
+            candidates << caller->addr;
+        }
+    }
+    return candidates;
+}
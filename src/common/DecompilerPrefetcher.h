@@ -0,0 +1,69 @@
+#ifndef DECOMPILERPREFETCHER_H
+#define DECOMPILERPREFETCHER_H
+
+#include "core/CutterCommon.h"
+
+#include <rz_util/rz_annotated_code.h>
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+class Decompiler;
+
+/**
+ * @brief Decompiles the functions likely to be visited next while the decompiler is idle.
+ *
+ * After a function has been shown, its callees, ranked by the number of calls, and then its
+ * callers are decompiled one by one into the DecompilationCache of CutterCore. Work starts only
+ * after the user stopped navigating for a moment and is limited by the number of functions, a
+ * time budget and the share of time the decompiler may be kept busy (see Configuration).
+ *
+ * Background requests are only made while the decompiler has no other requests, so any
+ * foreground request supersedes them. Foreground users should still call cancel() to drop the
+ * pending work.
+ */
+class CUTTER_EXPORT DecompilerPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DecompilerPrefetcher(QObject *parent = nullptr);
+    ~DecompilerPrefetcher() override;
+
+    /**
+     * @brief Replace the pending work with the neighbors of \a function
+     */
+    void schedule(Decompiler *decompiler, RVA function);
+    /**
+     * @brief Drop the pending work and cancel the running decompilation
+     */
+    void cancel();
+
+private slots:
+    void startNext();
+    void decompilationFinished(quint64 requestId, RzAnnotatedCode *code);
+
+private:
+    /// Time without navigation before the first prefetch starts
+    static constexpr int IDLE_DELAY_MS = 1000;
+
+    static QList<RVA> rankCandidates(RVA function);
+
+    QPointer<Decompiler> decompiler;
+    QList<RVA> candidates;
+    int remaining = 0;
+    QElapsedTimer budgetTimer;
+    QTimer startTimer;
+
+    /// Decompiler currently working for us
+    QPointer<Decompiler> runningDecompiler;
+    quint64 runningRequest = 0;
+    RVA runningFunction = RVA_INVALID;
+    quint64 runningGeneration = 0;
+    QElapsedTimer runningTimer;
+};
+
+#endif // DECOMPILERPREFETCHER_H
@@ -0,0 +1,77 @@
+#include "FileHashesTask.h"
+
+#include <algorithm>
+#include <memory>
+
+static const char *const HASH_ALGORITHMS[] = { "md5", "sha1", "sha256", "crc32", "entropy" };
+
+FileHashesTask::FileHashesTask(int fd, const QString &identity) : fd(fd), identity(identity) {}
+
+void FileHashesTask::runTask()
+{
+    std::unique_ptr<RzHashCfg, decltype(&rz_hash_cfg_free)> md(nullptr, rz_hash_cfg_free);
+    ut64 size;
+    {
+        RzCoreLocked core(Core());
+        RzIODesc *desc = rz_io_desc_get(core->io, fd);
+        if (!desc) {
+            return;
+        }
+        size = rz_io_desc_size(desc);
+        md.reset(rz_hash_cfg_new(core->hash));
+    }
+    if (!md) {
+        return;
+    }
+    for (const char *algorithm : HASH_ALGORITHMS) {
+        if (!rz_hash_cfg_configure(md.get(), algorithm)) {
+            return;
+        }
+    }
+    if (!rz_hash_cfg_init(md.get())) {
+        return;
+    }
+
+    const ut64 chunkSize = CHUNK_SIZE;
+    QByteArray buffer(CHUNK_SIZE, Qt::Uninitialized);
+    int lastPercent = -1;
+    for (ut64 offset = 0; offset < size;) {
+        if (isInterrupted()) {
+            return;
+        }
+        int len = static_cast<int>(std::min(chunkSize, size - offset));
+        int read;
+        {
+            // The file may have been closed in the meantime, so look it up again for every chunk
+            RzCoreLocked core(Core());
+            RzIODesc *desc = rz_io_desc_get(core->io, fd);
+            if (!desc) {
+                return;
+            }
+            read = rz_io_desc_read_at(desc, offset, reinterpret_cast<ut8 *>(buffer.data()), len);
+        }
+        if (read <= 0) {
+            return;
+        }
+        rz_hash_cfg_update(md.get(), reinterpret_cast<const ut8 *>(buffer.constData()), read);
+        offset += read;
+
+        int percent = static_cast<int>(offset * 100 / size);
+        if (percent != lastPercent) {
+            lastPercent = percent;
+            emit progressChanged(percent);
+        }
+    }
+
+    if (!rz_hash_cfg_final(md.get())) {
+        return;
+    }
+    for (const char *algorithm : HASH_ALGORITHMS) {
+        FileHash hash;
+        hash.type = algorithm;
+        hash.hex = fromOwnedCharPtr(
+                rz_hash_cfg_get_result_string(md.get(), algorithm, nullptr, false));
+        hashes << hash;
+    }
+    successful = true;
+}
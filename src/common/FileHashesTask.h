@@ -0,0 +1,54 @@
+#ifndef FILEHASHESTASK_H
+#define FILEHASHESTASK_H
+
+#include "common/AsyncTask.h"
+#include "core/Cutter.h"
+
+struct FileHash
+{
+    QString type;
+    QString hex;
+};
+
+/**
+ * @brief Computes the hashes shown in the Dashboard for a whole file.
+ *
+ * The file is read through its RzIODesc in large chunks, taking the core lock only while reading
+ * a chunk. All digests are updated from the same chunk, so the file is read only once.
+ */
+class FileHashesTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    static constexpr int CHUNK_SIZE = 4 * 1024 * 1024;
+
+    /**
+     * @param fd RzIO file descriptor of the file to hash
+     * @param identity opaque key identifying the file, passed back unchanged in getIdentity()
+     */
+    FileHashesTask(int fd, const QString &identity);
+
+    QString getTitle() override { return tr("Computing file hashes"); }
+
+    const QString &getIdentity() const { return identity; }
+    /**
+     * @return whether all hashes were computed, false if interrupted or reading failed
+     */
+    bool isSuccessful() const { return successful; }
+    const QList<FileHash> &getHashes() const { return hashes; }
+
+signals:
+    void progressChanged(int percent);
+
+protected:
+    void runTask() override;
+
+private:
+    int fd;
+    QString identity;
+    bool successful = false;
+    QList<FileHash> hashes;
+};
+
+#endif // FILEHASHESTASK_H
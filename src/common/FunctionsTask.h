@@ -10,17 +10,25 @@ class FunctionsTask : public AsyncTask
     Q_OBJECT
 
 public:
+    /**
+     * @param since generation of the functions the receiver has, see CutterCore::getFunctionsDelta()
+     */
+    explicit FunctionsTask(quint64 since) : since(since) {}
+
     QString getTitle() override { return tr("Fetching Functions"); }
 
 signals:
-    void fetchFinished(const QList<FunctionDescription> &strings);
+    void fetchFinished(const FunctionsDelta &delta);
 
 protected:
     void runTask() override
     {
-        auto functions = Core()->getAllFunctions();
-        emit fetchFinished(functions);
+        auto delta = Core()->getFunctionsDelta(since);
+        emit fetchFinished(delta);
     }
+
+private:
+    quint64 since;
 };
 
 #endif // FUNCTIONSTASK_H
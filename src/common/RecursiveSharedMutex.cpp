@@ -0,0 +1,146 @@
+#include "RecursiveSharedMutex.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+void RecursiveSharedMutex::setTransitionCallbacks(std::function<void()> onFirstLock,
+                                                  std::function<void()> onLastUnlock)
+{
+    QMutexLocker locker(&stateMutex);
+    this->onFirstLock = std::move(onFirstLock);
+    this->onLastUnlock = std::move(onLastUnlock);
+}
+
+bool RecursiveSharedMutex::canAcquire(Mode mode) const
+{
+    if (writer) {
+        return false;
+    }
+    if (mode == Mode::Shared) {
+        return waitingWriters == 0;
+    }
+    return readerDepths.isEmpty();
+}
+
+void RecursiveSharedMutex::lock(Mode mode)
+{
+    Qt::HANDLE self = QThread::currentThreadId();
+    QMutexLocker locker(&stateMutex);
+
+    if (mode == Mode::Shared) {
+        stats.sharedAcquisitions++;
+    } else {
+        stats.exclusiveAcquisitions++;
+    }
+
+    if (writer == self) {
+        writerDepth++;
+        totalDepth++;
+        return;
+    }
+
+    auto reader = readerDepths.find(self);
+    bool holdsShared = reader != readerDepths.end();
+    if (mode == Mode::Shared && holdsShared) {
+        // Never block here, a waiting writer would be waiting for us.
+        reader.value()++;
+        totalDepth++;
+        return;
+    }
+    if (holdsShared) {
+        // Two readers upgrading would wait for each other forever, so fail in every build
+        qFatal("RecursiveSharedMutex::lock: requesting exclusive access while holding shared "
+               "access");
+    }
+
+    if (!canAcquire(mode)) {
+        QElapsedTimer timer;
+        timer.start();
+        if (mode == Mode::Exclusive) {
+            waitingWriters++;
+        }
+        do {
+            stateChanged.wait(&stateMutex);
+        } while (!canAcquire(mode));
+        if (mode == Mode::Exclusive) {
+            waitingWriters--;
+        }
+        if (mode == Mode::Shared) {
+            stats.sharedContentions++;
+            stats.sharedWaitNs += timer.nsecsElapsed();
+        } else {
+            stats.exclusiveContentions++;
+            stats.exclusiveWaitNs += timer.nsecsElapsed();
+        }
+    }
+
+    if (totalDepth == 0 && onFirstLock) {
+        onFirstLock();
+    }
+    totalDepth++;
+
+    if (mode == Mode::Exclusive) {
+        writer = self;
+        writerDepth = 1;
+    } else {
+        readerDepths.insert(self, 1);
+        stats.maxConcurrentReaders =
+                std::max(stats.maxConcurrentReaders, static_cast<int>(readerDepths.size()));
+    }
+}
+
+void RecursiveSharedMutex::unlock()
+{
+    Qt::HANDLE self = QThread::currentThreadId();
+    QMutexLocker locker(&stateMutex);
+
+    bool released = false;
+    if (writer == self) {
+        writerDepth--;
+        if (writerDepth == 0) {
+            writer = nullptr;
+            released = true;
+        }
+    } else {
+        auto reader = readerDepths.find(self);
+        Q_ASSERT_X(reader != readerDepths.end(), "RecursiveSharedMutex::unlock",
+                   "unlocking a mutex not held by the current thread");
+        if (reader == readerDepths.end()) {
+            return;
+        }
+        reader.value()--;
+        if (reader.value() == 0) {
+            readerDepths.erase(reader);
+            released = true;
+        }
+    }
+
+    Q_ASSERT(totalDepth > 0);
+    totalDepth--;
+    if (totalDepth == 0 && onLastUnlock) {
+        onLastUnlock();
+    }
+    if (released) {
+        stateChanged.wakeAll();
+    }
+}
+
+bool RecursiveSharedMutex::isLockedExclusively()
+{
+    QMutexLocker locker(&stateMutex);
+    return writer == QThread::currentThreadId();
+}
+
+SharedMutexStatistics RecursiveSharedMutex::statistics()
+{
+    QMutexLocker locker(&stateMutex);
+    return stats;
+}
+
+void RecursiveSharedMutex::resetStatistics()
+{
+    QMutexLocker locker(&stateMutex);
+    stats = SharedMutexStatistics();
+}
@@ -0,0 +1,91 @@
+#ifndef RECURSIVESHAREDMUTEX_H
+#define RECURSIVESHAREDMUTEX_H
+
+#include "core/CutterCommon.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <functional>
+
+/**
+ * @brief Usage counters of a RecursiveSharedMutex
+ *
+ * Contentions count the acquisitions which had to block because another thread was holding the
+ * mutex in an incompatible mode. Wait times are accumulated only for those.
+ */
+struct CUTTER_EXPORT SharedMutexStatistics
+{
+    quint64 sharedAcquisitions = 0;
+    quint64 exclusiveAcquisitions = 0;
+    quint64 sharedContentions = 0;
+    quint64 exclusiveContentions = 0;
+    quint64 sharedWaitNs = 0;
+    quint64 exclusiveWaitNs = 0;
+    int maxConcurrentReaders = 0;
+};
+
+/**
+ * @brief Reader/writer mutex which can be locked recursively by the same thread
+ *
+ * Any number of threads may hold the mutex in shared mode at the same time, exclusive mode is
+ * only granted when no other thread holds it. Nested locking from a thread which already holds
+ * the mutex never blocks. Requesting exclusive access while holding shared access is not
+ * supported and aborts the program in all builds, since two threads doing it would deadlock.
+ * Code running in shared mode must never call into code requiring exclusive mode.
+ *
+ * Locking shared while holding exclusive is treated as another level of exclusive locking.
+ * Waiting writers block new readers, so a steady stream of readers can't starve writers.
+ */
+class CUTTER_EXPORT RecursiveSharedMutex
+{
+public:
+    enum class Mode { Shared, Exclusive };
+
+    RecursiveSharedMutex() = default;
+    RecursiveSharedMutex(const RecursiveSharedMutex &) = delete;
+    RecursiveSharedMutex &operator=(const RecursiveSharedMutex &) = delete;
+
+    /**
+     * @brief Set callbacks for the transitions between unlocked and locked state
+     * @param onFirstLock called after the mutex got acquired while nobody was holding it
+     * @param onLastUnlock called when the last holder, in any mode, releases the mutex
+     *
+     * Both callbacks are invoked while the internal state is locked, so no other thread can
+     * acquire the mutex before onFirstLock has returned.
+     */
+    void setTransitionCallbacks(std::function<void()> onFirstLock,
+                                std::function<void()> onLastUnlock);
+
+    void lock(Mode mode);
+    void unlock();
+
+    /**
+     * @return whether the calling thread currently holds the mutex in exclusive mode
+     */
+    bool isLockedExclusively();
+
+    SharedMutexStatistics statistics();
+    void resetStatistics();
+
+private:
+    bool canAcquire(Mode mode) const;
+
+    QMutex stateMutex;
+    QWaitCondition stateChanged;
+
+    Qt::HANDLE writer = nullptr;
+    int writerDepth = 0;
+    int waitingWriters = 0;
+    QHash<Qt::HANDLE, int> readerDepths;
+    int totalDepth = 0;
+
+    std::function<void()> onFirstLock;
+    std::function<void()> onLastUnlock;
+
+    SharedMutexStatistics stats;
+};
+
+#endif // RECURSIVESHAREDMUTEX_H
@@ -157,6 +157,36 @@ RichTextPainter::List RichTextPainter::fromTextDocument(const QTextDocument &doc
     return r;
 }
 
+RichTextPainter::List RichTextPainter::fromTextRuns(const QVector<DisassemblyTextRun> &runs)
+{
+    List r;
+    r.reserve(runs.size());
+
+    for (const DisassemblyTextRun &run : runs) {
+        CustomRichText_t text;
+        text.text = run.text;
+        text.text.remove(QLatin1Char('\n'));
+        text.textColor = run.color;
+        text.textBackground = run.background;
+
+        bool hasForeground = run.color.isValid();
+        bool hasBackground = run.background.isValid();
+        if (hasForeground && !hasBackground) {
+            text.flags = FlagColor;
+        } else if (!hasForeground && hasBackground) {
+            text.flags = FlagBackground;
+        } else if (hasForeground && hasBackground) {
+            text.flags = FlagAll;
+        } else {
+            text.flags = FlagNone;
+        }
+
+        r.push_back(text);
+    }
+
+    return r;
+}
+
 RichTextPainter::List RichTextPainter::cropped(const RichTextPainter::List &richText, int maxCols,
                                                const QString &indicator, bool *croppedOut)
 {
@@ -3,6 +3,7 @@
 #define RICHTEXTPAINTER_H
 
 #include "common/Metrics.h"
+#include "core/CutterDescriptions.h"
 
 #include <QString>
 #include <QTextDocument>
@@ -41,6 +42,10 @@ public:
     static void htmlRichText(const List &richText, QString &textHtml, QString &textPlain);
 
     static List fromTextDocument(const QTextDocument &doc);
+    /**
+     * @brief Convert colored runs, dropping line breaks like fromTextDocument does.
+     */
+    static List fromTextRuns(const QVector<DisassemblyTextRun> &runs);
 
     static List cropped(const List &richText, int maxCols, const QString &indicator = nullptr,
                         bool *croppedOut = nullptr);
@@ -1,26 +1,53 @@
-
 #ifndef STRINGSASYNCTASK_H
 #define STRINGSASYNCTASK_H
 
 #include "common/AsyncTask.h"
 #include "core/Cutter.h"
 
+/**
+ * @brief Loads all strings of the current file, delivering them in chunks while loading
+ *
+ * Interrupting the task stops it after the current chunk.
+ */
 class StringsTask : public AsyncTask
 {
     Q_OBJECT
 
 public:
+    /**
+     * @param chunkSize maximum number of strings per stringsFound() signal
+     */
+    explicit StringsTask(int chunkSize) : chunkSize(chunkSize) {}
+
     QString getTitle() override { return tr("Searching for Strings"); }
 
 signals:
-    void stringSearchFinished(const QList<StringDescription> &strings);
+    /**
+     * @brief Emitted for every chunk of strings, in the order of the file
+     */
+    void stringsFound(const StringDescriptionColumns &strings);
+    /**
+     * @param complete false if the task was interrupted before all strings were found
+     */
+    void stringSearchFinished(bool complete);
 
 protected:
     void runTask() override
     {
-        auto strings = Core()->getAllStrings();
-        emit stringSearchFinished(strings);
+        bool complete =
+                Core()->getAllStringsColumns(chunkSize, [this](StringDescriptionColumns &&strings) {
+                    if (isInterrupted()) {
+                        return false;
+                    }
+                    // Queued connections share the columns, they are not copied
+                    emit stringsFound(strings);
+                    return true;
+                });
+        emit stringSearchFinished(complete);
     }
+
+private:
+    int chunkSize;
 };
 
 #endif // STRINGSASYNCTASK_H
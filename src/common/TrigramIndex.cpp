@@ -0,0 +1,98 @@
+#include "TrigramIndex.h"
+
+#include <algorithm>
+
+quint64 TrigramIndex::trigram(const QChar *text)
+{
+    quint64 key = 0;
+    for (int i = 0; i < 3; i++) {
+        ushort c = text[i].unicode();
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        key = (key << 16) | c;
+    }
+    return key;
+}
+
+void TrigramIndex::addRow(const QString &text)
+{
+    int row = rows++;
+    const QChar *data = text.constData();
+    for (int i = 0; i + MIN_LENGTH <= text.size(); i++) {
+        QVector<int> &rowsWithTrigram = postings[trigram(data + i)];
+        // Rows are added in ascending order, so a repeated trigram of this row is the last one
+        if (rowsWithTrigram.isEmpty() || rowsWithTrigram.last() != row) {
+            rowsWithTrigram.append(row);
+        }
+    }
+}
+
+bool TrigramIndex::candidates(const QString &text, QVector<int> &result) const
+{
+    result.clear();
+    if (text.size() < MIN_LENGTH) {
+        return false;
+    }
+
+    QVector<const QVector<int> *> lists;
+    const QChar *data = text.constData();
+    for (int i = 0; i + MIN_LENGTH <= text.size(); i++) {
+        auto it = postings.constFind(trigram(data + i));
+        if (it == postings.constEnd()) {
+            return true;
+        }
+        if (!lists.contains(&it.value())) {
+            lists.append(&it.value());
+        }
+    }
+
+    // Intersect starting with the shortest list, so the intermediate results stay small
+    std::sort(lists.begin(), lists.end(),
+              [](const QVector<int> *a, const QVector<int> *b) { return a->size() < b->size(); });
+    result = *lists.first();
+    for (int i = 1; i < lists.size() && !result.isEmpty(); i++) {
+        const QVector<int> &list = *lists[i];
+        QVector<int> intersection;
+        auto it = list.constBegin();
+        for (int row : result) {
+            it = std::lower_bound(it, list.constEnd(), row);
+            if (it == list.constEnd()) {
+                break;
+            }
+            if (*it == row) {
+                intersection.append(row);
+            }
+        }
+        result.swap(intersection);
+    }
+    return true;
+}
+
+TrigramIndexTask::TrigramIndexTask(std::unique_ptr<TrigramIndex> index,
+                                   const QVector<QString> &texts)
+    : index(std::move(index)), texts(texts)
+{
+    if (!this->index) {
+        this->index.reset(new TrigramIndex());
+    }
+}
+
+std::unique_ptr<TrigramIndex> TrigramIndexTask::takeIndex()
+{
+    if (!complete) {
+        return nullptr;
+    }
+    return std::move(index);
+}
+
+void TrigramIndexTask::runTask()
+{
+    for (int i = 0; i < texts.size(); i++) {
+        if (i % 4096 == 0 && isInterrupted()) {
+            return;
+        }
+        index->addRow(texts[i]);
+    }
+    complete = true;
+}
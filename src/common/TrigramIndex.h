@@ -0,0 +1,76 @@
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include "core/CutterCommon.h"
+#include "common/AsyncTask.h"
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+/**
+ * @brief Index of the trigrams of a list of texts, used to find the rows containing a substring
+ *
+ * Rows are numbered in the order they are added. ASCII letters are indexed case insensitively,
+ * so candidates() returns a superset of the rows containing the text with either case
+ * sensitivity and the caller has to verify them.
+ */
+class CUTTER_EXPORT TrigramIndex
+{
+public:
+    /// Texts shorter than this can't be looked up
+    static constexpr int MIN_LENGTH = 3;
+
+    int rowCount() const { return rows; }
+
+    /**
+     * @brief Add \a text as the next row
+     */
+    void addRow(const QString &text);
+
+    /**
+     * @brief Find the rows which may contain \a text
+     * @param result rows containing all trigrams of \a text, in ascending order
+     * @return false if \a text is shorter than MIN_LENGTH, all rows are candidates then
+     */
+    bool candidates(const QString &text, QVector<int> &result) const;
+
+private:
+    static quint64 trigram(const QChar *text);
+
+    int rows = 0;
+    QHash<quint64, QVector<int>> postings;
+};
+
+/**
+ * @brief Adds texts to a TrigramIndex in the background
+ */
+class TrigramIndexTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param index index to add \a texts to, nullptr to start a new one
+     */
+    TrigramIndexTask(std::unique_ptr<TrigramIndex> index, const QVector<QString> &texts);
+
+    QString getTitle() override { return tr("Indexing list for filtering"); }
+
+    /**
+     * @return the index with all texts added, nullptr if the task was interrupted
+     */
+    std::unique_ptr<TrigramIndex> takeIndex();
+
+protected:
+    void runTask() override;
+
+private:
+    std::unique_ptr<TrigramIndex> index;
+    QVector<QString> texts;
+    bool complete = false;
+};
+
+#endif // TRIGRAMINDEX_H
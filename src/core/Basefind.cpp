@@ -64,7 +64,7 @@ void Basefind::run()
     continue_run = true;
     mutex.unlock();
 
-    core->coreMutex.lock();
+    core->coreMutex.lock(RecursiveSharedMutex::Mode::Exclusive);
     options.callback = threadCallback;
     options.user = this;
     scores = rz_basefind(core->core_, &options);
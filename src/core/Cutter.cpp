@@ -7,8 +7,12 @@
 #include <QStringList>
 #include <QStandardPaths>
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
+#include <map>
 #include <memory>
+#include <vector>
 
 #include "common/TempConfig.h"
 #include "common/BasicInstructionHighlighter.h"
@@ -19,6 +23,7 @@
 #include "common/Json.h"
 #include "core/Cutter.h"
 #include "Decompiler.h"
+#include "common/DecompilerPrefetcher.h"
 
 #include <rz_asm.h>
 #include <rz_cmd.h>
@@ -128,25 +133,13 @@ static bool reg_sync(RzCore *core, RzRegisterType type, bool write)
     return true;
 }
 
-RzCoreLocked::RzCoreLocked(CutterCore *core) : core(core)
+RzCoreLocked::RzCoreLocked(CutterCore *core, RecursiveSharedMutex::Mode mode) : core(core)
 {
-    core->coreMutex.lock();
-    assert(core->coreLockDepth >= 0);
-    core->coreLockDepth++;
-    if (core->coreLockDepth == 1) {
-        assert(core->coreBed);
-        rz_cons_sleep_end(core->coreBed);
-        core->coreBed = nullptr;
-    }
+    core->coreMutex.lock(mode);
 }
 
 RzCoreLocked::~RzCoreLocked()
 {
-    assert(core->coreLockDepth > 0);
-    core->coreLockDepth--;
-    if (core->coreLockDepth == 0) {
-        core->coreBed = rz_cons_sleep_begin();
-    }
     core->coreMutex.unlock();
 }
 
@@ -161,6 +154,7 @@ RzCore *RzCoreLocked::operator->() const
 }
 
 #define CORE_LOCK() RzCoreLocked core(this)
+#define CORE_LOCK_SHARED() RzCoreLocked core(this, RecursiveSharedMutex::Mode::Shared)
 
 static void cutterREventCallback(RzEvent *, int type, void *user, void *data)
 {
@@ -168,12 +162,7 @@ static void cutterREventCallback(RzEvent *, int type, void *user, void *data)
     core->handleREvent(type, data);
 }
 
-CutterCore::CutterCore(QObject *parent)
-    : QObject(parent)
-#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
-      ,
-      coreMutex(QMutex::Recursive)
-#endif
+CutterCore::CutterCore(QObject *parent) : QObject(parent)
 {
     if (uniqueInstance) {
         throw std::logic_error("Only one instance of CutterCore must exist");
@@ -201,6 +190,13 @@ void CutterCore::initialize(bool loadPlugins)
     core_ = rz_core_new();
     rz_core_task_sync_begin(&core_->tasks);
     coreBed = rz_cons_sleep_begin();
+    coreMutex.setTransitionCallbacks(
+            [this]() {
+                assert(coreBed);
+                rz_cons_sleep_end(coreBed);
+                coreBed = nullptr;
+            },
+            [this]() { coreBed = rz_cons_sleep_begin(); });
     CORE_LOCK();
 
     rz_event_hook(core_->analysis->ev, RZ_EVENT_ALL, cutterREventCallback, this);
@@ -226,6 +222,186 @@ void CutterCore::initialize(bool loadPlugins)
 
     // Initialize Async tasks manager
     asyncTaskManager = new AsyncTaskManager(this);
+
+    connectDisassemblyCacheInvalidation();
+}
+
+/**
+ * @brief End of the range affected by a change of \a size bytes at \a offset
+ */
+static RVA instructionChangeEnd(RVA offset, RVA size, RVA following)
+{
+    RVA end = offset > RVA_MAX - size ? RVA_MAX : offset + size;
+    return end > RVA_MAX - following ? RVA_MAX : end + following;
+}
+
+void CutterCore::connectDisassemblyCacheInvalidation()
+{
+    auto invalidateAll = [this]() { invalidateDisassemblyCache(); };
+    connect(this, &CutterCore::refreshAll, this, invalidateAll);
+    connect(this, &CutterCore::functionRenamed, this, invalidateAll);
+    connect(this, &CutterCore::varsChanged, this, invalidateAll);
+    connect(this, &CutterCore::globalVarsChanged, this, invalidateAll);
+    connect(this, &CutterCore::functionsChanged, this, invalidateAll);
+    connect(this, &CutterCore::flagsChanged, this, invalidateAll);
+    connect(this, &CutterCore::registersChanged, this, invalidateAll);
+    connect(this, &CutterCore::refreshCodeViews, this, invalidateAll);
+    connect(this, &CutterCore::stackChanged, this, invalidateAll);
+    connect(this, &CutterCore::codeRebased, this, invalidateAll);
+    connect(this, &CutterCore::switchedThread, this, invalidateAll);
+    connect(this, &CutterCore::switchedProcess, this, invalidateAll);
+    connect(this, &CutterCore::ioCacheChanged, this, invalidateAll);
+    connect(this, &CutterCore::writeModeChanged, this, invalidateAll);
+    connect(this, &CutterCore::ioModeChanged, this, invalidateAll);
+    connect(this, &CutterCore::asmOptionsChanged, this, invalidateAll);
+    connect(Config(), &Configuration::colorsUpdated, this, invalidateAll);
+
+    connect(this, &CutterCore::commentsChanged, this,
+            [this](RVA addr) { invalidateDisassemblyCache(addr, addr + 1); });
+    connect(this, &CutterCore::breakpointsChanged, this,
+            [this](RVA addr) { invalidateDisassemblyCache(addr, addr + 1); });
+    connect(this, &CutterCore::instructionChanged, this, [this](RVA addr, RVA size) {
+        invalidateDisassemblyCache(addr,
+                                   instructionChangeEnd(addr, size, INSTRUCTION_CHANGE_RANGE));
+    });
+
+    // Instruction boundaries only depend on the bytes, the analysis and the code/data meta data
+    auto invalidateIndex = [this]() {
+        CORE_LOCK();
+        instructionIndex.invalidate();
+    };
+    connect(this, &CutterCore::refreshAll, this, invalidateIndex);
+    connect(this, &CutterCore::functionsChanged, this, invalidateIndex);
+    connect(this, &CutterCore::refreshCodeViews, this, invalidateIndex);
+    connect(this, &CutterCore::stackChanged, this, invalidateIndex);
+    connect(this, &CutterCore::codeRebased, this, invalidateIndex);
+    connect(this, &CutterCore::ioCacheChanged, this, invalidateIndex);
+    connect(this, &CutterCore::writeModeChanged, this, invalidateIndex);
+    connect(this, &CutterCore::ioModeChanged, this, invalidateIndex);
+    connect(this, &CutterCore::asmOptionsChanged, this, invalidateIndex);
+    connect(this, &CutterCore::instructionChanged, this, [this](RVA addr, RVA size) {
+        CORE_LOCK();
+        instructionIndex.invalidate(addr,
+                                    instructionChangeEnd(addr, size, INSTRUCTION_CHANGE_RANGE));
+    });
+
+    // Breakpoints changed by rizin itself, e.g. while debugging
+    auto invalidateBreakpoints = [this]() {
+        CORE_LOCK();
+        breakpointIndexValid = false;
+    };
+    connect(this, &CutterCore::refreshAll, this, invalidateBreakpoints);
+    connect(this, &CutterCore::refreshCodeViews, this, invalidateBreakpoints);
+    connect(this, &CutterCore::registersChanged, this, invalidateBreakpoints);
+    connect(this, &CutterCore::switchedProcess, this, invalidateBreakpoints);
+    connect(this, &CutterCore::debugTaskStateChanged, this, invalidateBreakpoints);
+
+    // Anything shown in decompiled code
+    auto increaseGeneration = [this]() { increaseAnalysisGeneration(); };
+    connect(this, &CutterCore::refreshAll, this, increaseGeneration);
+    connect(this, &CutterCore::functionRenamed, this, increaseGeneration);
+    connect(this, &CutterCore::varsChanged, this, increaseGeneration);
+    connect(this, &CutterCore::globalVarsChanged, this, increaseGeneration);
+    connect(this, &CutterCore::typesChanged, this, increaseGeneration);
+    connect(this, &CutterCore::functionsChanged, this, increaseGeneration);
+    connect(this, &CutterCore::flagsChanged, this, increaseGeneration);
+    connect(this, &CutterCore::commentsChanged, this, increaseGeneration);
+    connect(this, &CutterCore::instructionChanged, this, increaseGeneration);
+    connect(this, &CutterCore::refreshCodeViews, this, increaseGeneration);
+    connect(this, &CutterCore::codeRebased, this, increaseGeneration);
+    connect(this, &CutterCore::ioCacheChanged, this, increaseGeneration);
+    connect(this, &CutterCore::writeModeChanged, this, increaseGeneration);
+    connect(this, &CutterCore::ioModeChanged, this, increaseGeneration);
+}
+
+void CutterCore::increaseAnalysisGeneration()
+{
+    analysisGeneration++;
+    // Nothing of an older generation can be used anymore
+    decompilationCache.invalidate();
+}
+
+bool CutterCore::buildInstructionIndexPage(RVA address, RVA from,
+                                           InstructionBoundaryIndex::Page &page)
+{
+    CORE_LOCK();
+    const RVA pageSize = InstructionBoundaryIndex::PAGE_BYTES;
+    if (address > RVA_MAX - pageSize || !rz_io_is_valid_offset(core->io, address, 0)) {
+        return false;
+    }
+    RVA end = address + pageSize;
+
+    // Instructions known from the analysis, mapped to their size
+    std::map<RVA, RVA> known;
+    rz_analysis_blocks_foreach_intersect(
+            core->analysis, address, pageSize,
+            [](RzAnalysisBlock *block, void *user) -> bool {
+                auto known = static_cast<std::map<RVA, RVA> *>(user);
+                for (int i = 0; i < block->ninstr; i++) {
+                    RVA op = rz_analysis_block_get_op_addr(block, i);
+                    RVA next = i + 1 < block->ninstr ? rz_analysis_block_get_op_addr(block, i + 1)
+                                                     : block->addr + block->size;
+                    if (op != UT64_MAX && next > op) {
+                        known->emplace(op, next - op);
+                    }
+                }
+                return true;
+            },
+            &known);
+
+    page.anchored = from != RVA_INVALID;
+    if (from == RVA_INVALID) {
+        // Continue after a known instruction reaching into the page, otherwise guess
+        from = address;
+        auto it = known.lower_bound(address);
+        if (it != known.begin() && std::prev(it)->first + std::prev(it)->second > address) {
+            from = std::prev(it)->first + std::prev(it)->second;
+            page.anchored = true;
+        } else if (it != known.end() && it->first == address) {
+            page.anchored = true;
+        }
+    }
+
+    const int maxOpSize = 32;
+    QByteArray bytes(static_cast<int>(pageSize) + maxOpSize, '\0');
+    if (from < end) {
+        rz_io_read_at(core->io, address, reinterpret_cast<ut8 *>(bytes.data()), bytes.size());
+    }
+
+    RVA pos = from;
+    while (pos < end) {
+        page.starts.set(pos - address);
+        RVA size;
+        ut64 metaSize = 0;
+        auto it = known.find(pos);
+        if (it != known.end()) {
+            size = it->second;
+        } else if (rz_meta_get_at(core->analysis, pos, RZ_META_TYPE_DATA, &metaSize)
+                   || rz_meta_get_at(core->analysis, pos, RZ_META_TYPE_STRING, &metaSize)) {
+            size = metaSize;
+        } else {
+            RzAnalysisOp op;
+            rz_analysis_op_init(&op);
+            int offset = static_cast<int>(pos - address);
+            rz_analysis_op(core->analysis, &op, pos,
+                           reinterpret_cast<const ut8 *>(bytes.constData()) + offset,
+                           bytes.size() - offset, RZ_ANALYSIS_OP_MASK_BASIC);
+            size = op.size > 0 ? op.size : 1;
+            rz_analysis_op_fini(&op);
+        }
+        RVA next = pos + std::max<RVA>(size, 1);
+        // Get back in sync if the sweep ran over an instruction known from the analysis
+        auto sync = known.upper_bound(pos);
+        if (sync != known.end() && sync->first < next) {
+            next = sync->first;
+        }
+        if (next < pos) { // overflow
+            break;
+        }
+        pos = next;
+    }
+    page.next = pos;
+    return true;
 }
 
 CutterCore::~CutterCore()
@@ -244,6 +420,21 @@ RzCoreLocked CutterCore::core()
     return RzCoreLocked(this);
 }
 
+RzCoreLocked CutterCore::coreShared()
+{
+    return RzCoreLocked(this, RecursiveSharedMutex::Mode::Shared);
+}
+
+SharedMutexStatistics CutterCore::getCoreLockStatistics()
+{
+    return coreMutex.statistics();
+}
+
+void CutterCore::resetCoreLockStatistics()
+{
+    coreMutex.resetStatistics();
+}
+
 QDir CutterCore::getCutterRCDefaultDirectory() const
 {
     return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation);
@@ -361,6 +552,8 @@ QString CutterCore::cmd(const char *str)
     RVA offset = core->offset;
     char *res = rz_core_cmd_str(core, str);
     QString o = fromOwnedCharPtr(res);
+    // Commands can change anything without notifying
+    invalidateAfterCommand();
 
     if (offset != core->offset) {
         updateSeek();
@@ -456,22 +649,46 @@ void CutterCore::functionTask(std::function<void *(RzCore *)> fcn)
 }
 
 QString CutterCore::cmdRawAt(const char *cmd, RVA address)
+{
+    CORE_LOCK();
+    QString res = cmdRawAtReadOnly(cmd, address);
+    invalidateAfterCommand();
+    return res;
+}
+
+QString CutterCore::cmdRaw(const char *cmd)
+{
+    CORE_LOCK();
+    QString res = cmdRawReadOnly(cmd);
+    invalidateAfterCommand();
+    return res;
+}
+
+QString CutterCore::cmdRawAtReadOnly(const char *cmd, RVA address)
 {
     QString res;
     RVA oldOffset = getOffset();
     seekSilent(address);
 
-    res = cmdRaw(cmd);
+    res = cmdRawReadOnly(cmd);
 
     seekSilent(oldOffset);
     return res;
 }
 
-QString CutterCore::cmdRaw(const char *cmd)
+QString CutterCore::cmdRawReadOnly(const char *cmd)
 {
-    QString res;
     CORE_LOCK();
-    return rz_core_cmd_str(core, cmd);
+    return fromOwnedCharPtr(rz_core_cmd_str(core, cmd));
+}
+
+void CutterCore::invalidateAfterCommand()
+{
+    CORE_LOCK();
+    disassemblyCache.invalidate();
+    instructionIndex.invalidate();
+    breakpointIndexValid = false;
+    increaseAnalysisGeneration();
 }
 
 CutterJson CutterCore::cmdj(const char *str)
@@ -490,6 +707,12 @@ QString CutterCore::cmdTask(const QString &str)
     RizinCmdTask task(str);
     task.startTask();
     task.joinTask();
+    invalidateDisassemblyCache();
+    {
+        CORE_LOCK();
+        breakpointIndexValid = false;
+    }
+    increaseAnalysisGeneration();
     return task.getResult();
 }
 
@@ -751,8 +974,8 @@ void CutterCore::jmpReverse(RVA addr)
 void CutterCore::editBytes(RVA addr, const QString &bytes)
 {
     CORE_LOCK();
-    rz_core_write_hexpair(core, addr, bytes.toUtf8().constData());
-    emit instructionChanged(addr);
+    int written = rz_core_write_hexpair(core, addr, bytes.toUtf8().constData());
+    emit instructionChanged(addr, written > 0 ? written : 1);
 }
 
 void CutterCore::editBytesEndian(RVA addr, const QString &bytes)
@@ -764,6 +987,8 @@ void CutterCore::editBytesEndian(RVA addr, const QString &bytes)
     }
     rz_core_write_value_at(core, addr, value, 0);
     emit stackChanged();
+    // The value is written with the size of a pointer, at most 8 bytes
+    emit instructionChanged(addr, sizeof(ut64));
 }
 
 void CutterCore::setToCode(RVA addr)
@@ -801,14 +1026,19 @@ void CutterCore::setAsString(RVA addr, int size, StringTypeFormats type)
     CORE_LOCK();
     seekAndShow(addr);
     rz_core_meta_string_add(core, addr, size, encoding, nullptr);
-    emit instructionChanged(addr);
+    // The size of the string is guessed if none is given
+    ut64 stringSize = size > 0 ? static_cast<ut64>(size) : 1;
+    rz_meta_get_at(core->analysis, addr, RZ_META_TYPE_STRING, &stringSize);
+    emit instructionChanged(addr, stringSize);
 }
 
 void CutterCore::removeString(RVA addr)
 {
     CORE_LOCK();
+    ut64 stringSize = 1;
+    rz_meta_get_at(core->analysis, addr, RZ_META_TYPE_STRING, &stringSize);
     rz_meta_del(core->analysis, RZ_META_TYPE_STRING, addr, 1);
-    emit instructionChanged(addr);
+    emit instructionChanged(addr, stringSize);
 }
 
 QString CutterCore::getString(RVA addr)
@@ -847,7 +1077,7 @@ void CutterCore::setToData(RVA addr, int size, int repeat)
     for (int i = 0; i < repeat; ++i, address += size) {
         rz_meta_set(core->analysis, RZ_META_TYPE_DATA, address, size, nullptr);
     }
-    emit instructionChanged(addr);
+    emit instructionChanged(addr, address - addr);
 }
 
 int CutterCore::sizeofDataMeta(RVA addr)
@@ -879,7 +1109,7 @@ void CutterCore::delComment(RVA addr)
  */
 QString CutterCore::getCommentAt(RVA addr)
 {
-    CORE_LOCK();
+    CORE_LOCK_SHARED();
     return rz_meta_get_string(core->analysis, RZ_META_TYPE_COMMENT, addr);
 }
 
@@ -995,6 +1225,10 @@ void CutterCore::updateSeek(SeekHistoryType type)
 RVA CutterCore::prevOpAddr(RVA startAddr, int count)
 {
     CORE_LOCK();
+    RVA addr = instructionIndex.prevInstruction(startAddr, count);
+    if (addr != RVA_INVALID) {
+        return addr;
+    }
     return rz_core_prevop_addr_force(core, startAddr, count);
 }
 
@@ -1297,7 +1531,7 @@ RVA CutterCore::getLastFunctionInstruction(RVA addr)
 
 QString CutterCore::flagAt(RVA addr)
 {
-    CORE_LOCK();
+    CORE_LOCK_SHARED();
     RzFlagItem *f = rz_flag_get_at(core->flags, addr, true);
     if (!f) {
         return {};
@@ -1344,6 +1578,14 @@ Decompiler *CutterCore::getDecompilerById(const QString &id)
     return nullptr;
 }
 
+DecompilerPrefetcher *CutterCore::getDecompilerPrefetcher()
+{
+    if (!decompilerPrefetcher) {
+        decompilerPrefetcher = new DecompilerPrefetcher(this);
+    }
+    return decompilerPrefetcher;
+}
+
 bool CutterCore::registerDecompiler(Decompiler *decompiler)
 {
     if (getDecompilerById(decompiler->getId())) {
@@ -2632,6 +2874,7 @@ void CutterCore::toggleBreakpoint(RVA addr)
 {
     CORE_LOCK();
     rz_core_debug_breakpoint_toggle(core, addr);
+    breakpointIndexValid = false;
     emit breakpointsChanged(addr);
 }
 
@@ -2685,6 +2928,7 @@ void CutterCore::addBreakpoint(const BreakpointDescription &config)
     if (!config.command.isEmpty()) {
         updateOwnedCharPtr(breakpoint->data, config.command);
     }
+    breakpointIndexValid = false;
     emit breakpointsChanged(breakpoint->addr);
 }
 
@@ -2693,6 +2937,7 @@ void CutterCore::updateBreakpoint(int index, const BreakpointDescription &config
     CORE_LOCK();
     if (auto bp = rz_bp_get_index(core->dbg->bp, index)) {
         rz_bp_del(core->dbg->bp, bp->addr);
+        breakpointIndexValid = false;
     }
     // Delete by index currently buggy,
     // required for breakpoints with non address based position
@@ -2704,6 +2949,7 @@ void CutterCore::delBreakpoint(RVA addr)
 {
     CORE_LOCK();
     rz_bp_del(core->dbg->bp, addr);
+    breakpointIndexValid = false;
     emit breakpointsChanged(addr);
 }
 
@@ -2711,6 +2957,7 @@ void CutterCore::delAllBreakpoints()
 {
     CORE_LOCK();
     rz_bp_del_all(core->dbg->bp);
+    breakpointIndexValid = false;
     emit refreshCodeViews();
 }
 
@@ -2718,6 +2965,7 @@ void CutterCore::enableBreakpoint(RVA addr)
 {
     CORE_LOCK();
     rz_bp_enable(core->dbg->bp, addr, true, 1);
+    breakpointIndexValid = false;
     emit breakpointsChanged(addr);
 }
 
@@ -2725,6 +2973,7 @@ void CutterCore::disableBreakpoint(RVA addr)
 {
     CORE_LOCK();
     rz_bp_enable(core->dbg->bp, addr, false, 1);
+    breakpointIndexValid = false;
     emit breakpointsChanged(addr);
 }
 
@@ -2786,24 +3035,69 @@ QList<BreakpointDescription> CutterCore::getBreakpoints()
     return ret;
 }
 
-QList<RVA> CutterCore::getBreakpointsAddresses()
+void CutterCore::updateBreakpointIndex()
 {
-    QList<RVA> bpAddresses;
-    for (const BreakpointDescription &bp : getBreakpoints()) {
-        bpAddresses << bp.addr;
+    CORE_LOCK();
+    if (breakpointIndexValid) {
+        return;
+    }
+    breakpointSet.clear();
+    sortedBreakpoints.clear();
+    // TODO: use higher level API, don't touch rizin bps_idx directly
+    for (int i = 0; i < core->dbg->bp->bps_idx_count; i++) {
+        if (auto bpi = core->dbg->bp->bps_idx[i]) {
+            breakpointSet.insert(bpi->addr);
+            sortedBreakpoints << bpi->addr;
+        }
     }
+    std::sort(sortedBreakpoints.begin(), sortedBreakpoints.end());
+    breakpointIndexValid = true;
+}
+
+QList<RVA> CutterCore::getBreakpointsAddresses()
+{
+    CORE_LOCK();
+    updateBreakpointIndex();
+    return sortedBreakpoints;
+}
 
-    return bpAddresses;
+QSet<RVA> CutterCore::getBreakpointsAddressSet()
+{
+    CORE_LOCK();
+    updateBreakpointIndex();
+    return breakpointSet;
+}
+
+QList<RVA> CutterCore::getBreakpointsInRange(RVA from, RVA to)
+{
+    CORE_LOCK();
+    updateBreakpointIndex();
+    auto first = std::lower_bound(sortedBreakpoints.begin(), sortedBreakpoints.end(), from);
+    auto last = std::lower_bound(first, sortedBreakpoints.end(), to);
+    QList<RVA> result;
+    std::copy(first, last, std::back_inserter(result));
+    return result;
 }
 
 QList<RVA> CutterCore::getBreakpointsInFunction(RVA funcAddr)
 {
-    QList<RVA> allBreakpoints = getBreakpointsAddresses();
+    CORE_LOCK();
+    RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, funcAddr);
+    QList<RVA> candidates;
+    if (fcn) {
+        // Only look at the breakpoints inside of the basic blocks
+        for (auto bb : CutterPVector<RzAnalysisBlock>(fcn->bbs)) {
+            candidates << getBreakpointsInRange(bb->addr, bb->addr + bb->size);
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    } else {
+        candidates = getBreakpointsAddresses();
+    }
     QList<RVA> functionBreakpoints;
 
     // Use std manipulations to take only the breakpoints that belong to this function
-    std::copy_if(allBreakpoints.begin(), allBreakpoints.end(),
-                 std::back_inserter(functionBreakpoints),
+    std::copy_if(candidates.begin(), candidates.end(), std::back_inserter(functionBreakpoints),
                  [this, funcAddr](RVA BPadd) { return getFunctionStart(BPadd) == funcAddr; });
     return functionBreakpoints;
 }
@@ -2813,6 +3107,13 @@ bool CutterCore::isBreakpoint(const QList<RVA> &breakpoints, RVA addr)
     return breakpoints.contains(addr);
 }
 
+bool CutterCore::isBreakpoint(RVA addr)
+{
+    CORE_LOCK();
+    updateBreakpointIndex();
+    return breakpointSet.contains(addr);
+}
+
 QList<ProcessDescription> CutterCore::getProcessThreads(int pid = -1)
 {
     CORE_LOCK();
@@ -3044,10 +3345,11 @@ QList<RzAsmPluginDescription> CutterCore::getRAsmPluginDescriptions()
 
 QList<FunctionDescription> CutterCore::getAllFunctions()
 {
-    CORE_LOCK();
+    CORE_LOCK_SHARED();
 
     QList<FunctionDescription> funcList;
     funcList.reserve(rz_list_length(core->analysis->fcns));
+    StringInterner callTypes;
 
     RzListIter *iter;
     RzAnalysisFunction *fcn;
@@ -3058,7 +3360,7 @@ QList<FunctionDescription> CutterCore::getAllFunctions()
         function.nargs = rz_analysis_arg_count(fcn);
         function.nlocals = rz_analysis_var_local_count(fcn);
         function.nbbs = rz_pvector_len(fcn->bbs);
-        function.calltype = fcn->cc ? QString::fromUtf8(fcn->cc) : QString();
+        function.calltype = fcn->cc ? callTypes.intern(QString::fromUtf8(fcn->cc)) : QString();
         function.name = fcn->name ? QString::fromUtf8(fcn->name) : QString();
         function.edges = rz_analysis_function_count_edges(fcn, nullptr);
         function.stackframe = fcn->maxstack;
@@ -3068,6 +3370,22 @@ QList<FunctionDescription> CutterCore::getAllFunctions()
     return funcList;
 }
 
+FunctionsDelta CutterCore::getFunctionsDelta(quint64 since)
+{
+    quint64 analysis = getAnalysisGeneration();
+    FunctionsDelta delta;
+    {
+        QMutexLocker locker(&listDeltaMutex);
+        if (functionsTrackerAnalysis == analysis && functionsTracker.unchangedDelta(since, delta)) {
+            return delta;
+        }
+    }
+    QList<FunctionDescription> functions = getAllFunctions();
+    QMutexLocker locker(&listDeltaMutex);
+    functionsTrackerAnalysis = analysis;
+    return functionsTracker.update(functions, since);
+}
+
 static inline uint64_t rva(RzBinObject *o, uint64_t paddr, uint64_t vaddr, int va)
 {
     return va ? rz_bin_object_get_vaddr(o, paddr, vaddr) : paddr;
@@ -3086,6 +3404,7 @@ QList<ImportDescription> CutterCore::getAllImports()
     }
 
     QList<ImportDescription> qList;
+    StringInterner names;
     bool va = core->io->va || core->bin->is_debugger;
     for (const auto &import : CutterPVector<RzBinImport>(imports)) {
         if (RZ_STR_ISEMPTY(import->name)) {
@@ -3105,9 +3424,9 @@ QList<ImportDescription> CutterCore::getAllImports()
         }
 
         importDescription.ordinal = (int)import->ordinal;
-        importDescription.bind = import->bind;
-        importDescription.type = import->type;
-        importDescription.libname = import->libname;
+        importDescription.bind = names.intern(import->bind);
+        importDescription.type = names.intern(import->type);
+        importDescription.libname = names.intern(import->libname);
         importDescription.name = name;
         importDescription.plt = addr;
 
@@ -3134,6 +3453,7 @@ QList<ExportDescription> CutterCore::getAllExports()
     bool demangle = rz_config_get_b(core->config, "bin.demangle");
 
     QList<ExportDescription> ret;
+    StringInterner types;
     for (const auto &symbol : CutterPVector<RzBinSymbol>(symbols)) {
         if (!(symbol->name && rz_core_sym_is_export(symbol))) {
             continue;
@@ -3146,7 +3466,7 @@ QList<ExportDescription> CutterCore::getAllExports()
         exportDescription.vaddr = rva(bf->o, symbol->paddr, symbol->vaddr, va);
         exportDescription.paddr = symbol->paddr;
         exportDescription.size = symbol->size;
-        exportDescription.type = symbol->type;
+        exportDescription.type = types.intern(symbol->type);
         exportDescription.name = sn.symbolname;
         exportDescription.flag_name = sn.nameflag;
         ret << exportDescription;
@@ -3165,15 +3485,15 @@ QList<SymbolDescription> CutterCore::getAllSymbols()
     }
 
     QList<SymbolDescription> ret;
+    StringInterner names;
     const RzPVector *symbols = rz_bin_object_get_symbols(bf->o);
     if (symbols) {
         for (const auto &bs : CutterPVector<RzBinSymbol>(symbols)) {
-            QString type = QString(bs->bind) + " " + QString(bs->type);
             SymbolDescription symbol;
             symbol.vaddr = bs->vaddr;
             symbol.name = QString(bs->name);
-            symbol.bind = QString(bs->bind);
-            symbol.type = QString(bs->type);
+            symbol.bind = names.intern(QString(bs->bind));
+            symbol.type = names.intern(QString(bs->type));
             ret << symbol;
         }
     }
@@ -3307,20 +3627,43 @@ QList<RelocDescription> CutterCore::getAllRelocs()
 }
 
 QList<StringDescription> CutterCore::getAllStrings()
+{
+    StringDescriptionColumns columns = getAllStringsColumns();
+    QList<StringDescription> ret;
+    ret.reserve(columns.size());
+    for (int i = 0; i < columns.size(); i++) {
+        ret << columns.at(i);
+    }
+    return ret;
+}
+
+StringDescriptionColumns CutterCore::getAllStringsColumns()
+{
+    StringDescriptionColumns ret;
+    getAllStringsColumns(std::numeric_limits<int>::max(),
+                         [&ret](StringDescriptionColumns &&strings) {
+                             ret = std::move(strings);
+                             return true;
+                         });
+    return ret;
+}
+
+bool CutterCore::getAllStringsColumns(
+        int chunkSize, const std::function<bool(StringDescriptionColumns &&)> &consumer)
 {
     CORE_LOCK();
     RzBinFile *bf = rz_bin_cur(core->bin);
     if (!bf) {
-        return {};
+        return true;
     }
     RzBinObject *obj = rz_bin_cur_object(core->bin);
     if (!obj) {
-        return {};
+        return true;
     }
 
     RzPVector *strings = rz_core_bin_whole_strings(core, bf);
     if (!strings) {
-        return {};
+        return true;
     }
 
     int va = core->io->va || core->bin->is_debugger;
@@ -3329,27 +3672,47 @@ QList<StringDescription> CutterCore::getAllStrings()
     opt.esc_bslash = true;
     opt.esc_double_quotes = true;
 
-    QList<StringDescription> ret;
+    // Types and section names are the same few texts for all strings, convert each only once
+    QHash<const char *, QString> names;
+    auto name = [&names](const char *cname) {
+        auto it = names.constFind(cname);
+        if (it == names.constEnd()) {
+            it = names.insert(cname, QString::fromUtf8(cname));
+        }
+        return it.value();
+    };
+
+    chunkSize = std::max(chunkSize, 1);
+    int chunkCapacity = std::min(chunkSize, static_cast<int>(rz_pvector_len(strings)));
+    StringDescriptionColumns chunk;
+    chunk.reserve(chunkCapacity);
     for (const auto &str : CutterPVector<RzBinString>(strings)) {
         auto section = obj ? rz_bin_get_section_at(obj, str->paddr, 0) : NULL;
 
         StringDescription string;
         string.string = rz_str_escape_utf8_keep_printable(str->string, &opt);
         string.vaddr = obj ? rva(obj, str->paddr, str->vaddr, va) : str->paddr;
-        string.type = rz_str_enc_as_string(str->type);
+        string.type = name(rz_str_enc_as_string(str->type));
         string.size = str->size;
         string.length = str->length;
-        string.section = section ? section->name : "";
+        string.section = name(section ? section->name : "");
 
-        ret << string;
+        chunk.append(string);
+        if (chunk.size() >= chunkSize) {
+            if (!consumer(std::move(chunk))) {
+                return false;
+            }
+            chunk = StringDescriptionColumns();
+            chunk.reserve(chunkCapacity);
+        }
     }
 
-    return ret;
+    return chunk.isEmpty() || consumer(std::move(chunk));
 }
 
 QList<FlagspaceDescription> CutterCore::getAllFlagspaces()
 {
-    CORE_LOCK();
+    CORE_LOCK_SHARED();
     QList<FlagspaceDescription> flagspaces;
     RzSpaceIter it;
     RzSpace *space;
@@ -3364,7 +3727,7 @@ QList<FlagspaceDescription> CutterCore::getAllFlagspaces()
 
 QList<FlagDescription> CutterCore::getAllFlags(QString flagspace)
 {
-    CORE_LOCK();
+    CORE_LOCK_SHARED();
     QList<FlagDescription> flags;
     std::string name = flagspace.isEmpty() || flagspace.isNull() ? "*" : flagspace.toStdString();
     RzSpace *space = rz_flag_space_get(core->flags, name.c_str());
@@ -3383,6 +3746,38 @@ QList<FlagDescription> CutterCore::getAllFlags(QString flagspace)
     return flags;
 }
 
+FlagsDelta CutterCore::getFlagsDelta(quint64 since, const QString &flagspace)
+{
+    quint64 analysis = getAnalysisGeneration();
+    FlagsDelta delta;
+    {
+        QMutexLocker locker(&listDeltaMutex);
+        auto it = flagsTrackers.constFind(flagspace);
+        if (it != flagsTrackers.constEnd() && it->analysisGeneration == analysis
+            && it->tracker.unchangedDelta(since, delta)) {
+            return delta;
+        }
+    }
+    QList<FlagDescription> flags = getAllFlags(flagspace);
+    QMutexLocker locker(&listDeltaMutex);
+    auto it = flagsTrackers.find(flagspace);
+    if (it == flagsTrackers.end()) {
+        if (flagsTrackers.size() >= MAX_FLAGS_TRACKERS) {
+            flagsTrackers.remove(flagsTrackersUse.takeFirst());
+        }
+        // Consumers of a dropped tracker of this flagspace get the whole list
+        FlagsTracker tracker { FlagsTracker::Tracker(4096, flagsTrackersGeneration + 1),
+                               analysis };
+        it = flagsTrackers.insert(flagspace, tracker);
+    }
+    flagsTrackersUse.removeOne(flagspace);
+    flagsTrackersUse.append(flagspace);
+    it->analysisGeneration = analysis;
+    delta = it->tracker.update(flags, since);
+    flagsTrackersGeneration = std::max(flagsTrackersGeneration, delta.generation);
+    return delta;
+}
+
 QList<SectionDescription> CutterCore::getAllSections()
 {
     CORE_LOCK();
@@ -3890,7 +4285,7 @@ QString CutterCore::getTypeAsC(QString name)
 
 bool CutterCore::isAddressMapped(RVA addr)
 {
-    CORE_LOCK();
+    CORE_LOCK_SHARED();
     return rz_io_map_get(core->io, addr);
 }
 
@@ -4117,15 +4512,48 @@ void CutterCore::addFlag(RVA offset, QString name, RVA size)
  */
 QString CutterCore::listFlagsAsStringAt(RVA addr)
 {
-    CORE_LOCK();
+    CORE_LOCK_SHARED();
     char *flagList = rz_flag_get_liststr(core->flags, addr);
     QString result = fromOwnedCharPtr(flagList);
     return result;
 }
 
+QVector<RVA> CutterCore::getFlagAndCommentAddresses(RVA start, RVA end)
+{
+    QVector<RVA> result;
+    if (end < start) {
+        return result;
+    }
+
+    CORE_LOCK_SHARED();
+    // The end of the range is exclusive, a flag at RVA_MAX itself is left out
+    rz_flag_foreach_range(
+            core->flags, start, end == RVA_MAX ? RVA_MAX : end + 1,
+            [](RzFlagItem *item, void *user) {
+                reinterpret_cast<QVector<RVA> *>(user)->append(item->offset);
+                return true;
+            },
+            &result);
+
+    RzPVector *comments = rz_meta_get_all_intersect(core->analysis, start, end - start + 1,
+                                                    RZ_META_TYPE_COMMENT);
+    if (comments) {
+        for (const auto &node : CutterPVector<RzIntervalNode>(comments)) {
+            if (node->start >= start && node->start <= end) {
+                result << node->start;
+            }
+        }
+        rz_pvector_free(comments);
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
 QString CutterCore::nearestFlag(RVA offset, RVA *flagOffsetOut)
 {
-    CORE_LOCK();
+    CORE_LOCK_SHARED();
     auto r = rz_flag_get_at(core->flags, offset, true);
     if (!r) {
         return {};
@@ -4201,12 +4629,46 @@ void CutterCore::loadPDB(const QString &file)
 }
 
 QList<DisassemblyLine> CutterCore::disassembleLines(RVA offset, int lines)
+{
+    return disassembleLines(offset, lines, DisassemblyTextFormat::Html);
+}
+
+QList<DisassemblyLine> CutterCore::disassembleLineRuns(RVA offset, int lines)
+{
+    return disassembleLines(offset, lines, DisassemblyTextFormat::Runs);
+}
+
+QList<DisassemblyLine> CutterCore::disassembleLines(RVA offset, int lines,
+                                                    DisassemblyTextFormat format)
 {
     CORE_LOCK();
+    quint64 optionsKey = disassemblyOptionsKey(format);
+    // Emulated values depend on where printing started, so such lines can't be reused
+    bool cacheable = !rz_config_get_b(core->config, "asm.emu")
+            && !rz_config_get_b(core->config, "emu.str");
+
+    // Take as many instructions as possible from the cache
+    QList<DisassemblyLine> r;
+    while (cacheable && r.size() < lines) {
+        const DisassemblyLineCache::Instruction *cached = disassemblyCache.find(optionsKey, offset);
+        if (!cached) {
+            break;
+        }
+        r << cached->lines;
+        if (cached->next <= offset) {
+            // end of the address space
+            return r;
+        }
+        offset = cached->next;
+    }
+    if (r.size() >= lines) {
+        return r;
+    }
+
     auto vec = fromOwned(
             rz_pvector_new(reinterpret_cast<RzPVectorFree>(rz_analysis_disasm_text_free)));
     if (!vec) {
-        return {};
+        return r;
     }
 
     RzCoreDisasmOptions options = {};
@@ -4218,11 +4680,23 @@ QList<DisassemblyLine> CutterCore::disassembleLines(RVA offset, int lines)
             rz_cons_singleton()->is_html = false;
             rz_cons_singleton()->was_html = true;
         }
-        rz_core_print_disasm(core, offset, core->block, core->blocksize, lines, NULL, &options);
+        rz_core_print_disasm(core, offset, core->block, core->blocksize, lines - r.size(), NULL,
+                             &options);
     }
 
-    QList<DisassemblyLine> r;
+    DisassemblyLineCache::Instruction instruction;
+    RVA instructionOffset = RVA_INVALID;
     for (const auto &t : CutterPVector<RzAnalysisDisasmText>(vec.get())) {
+        if (t->offset != instructionOffset) {
+            // All lines of an instruction are complete once the next one starts
+            if (cacheable && instructionOffset != RVA_INVALID) {
+                instruction.next = t->offset;
+                disassemblyCache.insert(optionsKey, instructionOffset, std::move(instruction));
+                instruction = DisassemblyLineCache::Instruction();
+            }
+            instructionOffset = t->offset;
+        }
+
         QString text = t->text;
         QStringList tokens = text.split('\n');
         // text might contain multiple lines
@@ -4231,16 +4705,58 @@ QList<DisassemblyLine> CutterCore::disassembleLines(RVA offset, int lines)
         for (const auto &tok : tokens) {
             DisassemblyLine line;
             line.offset = t->offset;
-            line.text = ansiEscapeToHtml(tok);
+            if (format == DisassemblyTextFormat::Html) {
+                line.text = ansiEscapeToHtml(tok);
+            } else {
+                line.runs = disassemblyTextRuns(t->offset, tok);
+            }
             line.arrow = t->arrow;
             r << line;
+            if (cacheable) {
+                instruction.lines << line;
+            }
             // only the first one.
             t->arrow = RVA_INVALID;
         }
     }
+    // The lines of the last instruction may have been cut off, so it is not cached
     return r;
 }
 
+quint64 CutterCore::disassemblyOptionsKey(DisassemblyTextFormat format)
+{
+    CORE_LOCK();
+    // Temporary configs differ between views, so all the relevant options are part of the key
+    static const char *const prefixes[] = { "asm.", "scr.", "emu.", "io.", "bin.", "cfg." };
+    quint64 key = static_cast<quint64>(format);
+    for (const auto &node : CutterRzList<RzConfigNode>(core->config->nodes)) {
+        bool relevant = false;
+        for (const char *prefix : prefixes) {
+            if (rz_str_startswith(node->name, prefix)) {
+                relevant = true;
+                break;
+            }
+        }
+        if (relevant && node->value) {
+            key = key * 31 + qHash(QLatin1String(node->name));
+            key = key * 31 + qHash(QLatin1String(node->value));
+        }
+    }
+    return key;
+}
+
+void CutterCore::invalidateDisassemblyCache()
+{
+    CORE_LOCK();
+    disassemblyCache.invalidate();
+}
+
+void CutterCore::invalidateDisassemblyCache(RVA from, RVA to)
+{
+    CORE_LOCK();
+    disassemblyCache.invalidate(from, to);
+}
+
 /**
  * @brief return hexdump of <size> from an <offset> by a given formats
  * @param address - the address from which to print the hexdump
@@ -4421,6 +4937,265 @@ QString CutterCore::ansiEscapeToHtml(const QString &text)
     return r;
 }
 
+static QColor ansiColor(int index)
+{
+    static const QRgb ANSI_COLORS[] = { 0x000000, 0x800000, 0x008000, 0x808000,
+                                        0x000080, 0x800080, 0x008080, 0xc0c0c0,
+                                        0x808080, 0xff0000, 0x00ff00, 0xffff00,
+                                        0x0000ff, 0xff00ff, 0x00ffff, 0xffffff };
+    if (index < 0 || index > 255) {
+        return QColor();
+    }
+    if (index < 16) {
+        return QColor(ANSI_COLORS[index]);
+    }
+    if (index < 232) {
+        // 6x6x6 color cube
+        static const int levels[] = { 0, 95, 135, 175, 215, 255 };
+        index -= 16;
+        return QColor(levels[index / 36], levels[(index / 6) % 6], levels[index % 6]);
+    }
+    int gray = 8 + (index - 232) * 10;
+    return QColor(gray, gray, gray);
+}
+
+static DisassemblyTokenType asmTokenType(RzAsmTokenType type)
+{
+    switch (type) {
+    case RZ_ASM_TOKEN_MNEMONIC:
+        return DisassemblyTokenType::Mnemonic;
+    case RZ_ASM_TOKEN_REGISTER:
+        return DisassemblyTokenType::Register;
+    case RZ_ASM_TOKEN_NUMBER:
+        return DisassemblyTokenType::Immediate;
+    case RZ_ASM_TOKEN_OPERATOR:
+    case RZ_ASM_TOKEN_SEPARATOR:
+        return DisassemblyTokenType::Separator;
+    default:
+        return DisassemblyTokenType::Text;
+    }
+}
+
+QVector<DisassemblyTextRun> CutterCore::disassemblyTextRuns(RVA offset, const QString &text)
+{
+    const QVector<DisassemblyTextRun> colored = ansiEscapeToRuns(text);
+    QString plain;
+    for (const DisassemblyTextRun &run : colored) {
+        plain += run.text;
+    }
+    QVector<DisassemblyTokenType> types(plain.size(), DisassemblyTokenType::Text);
+    auto setType = [&types](int from, int to, DisassemblyTokenType type) {
+        for (int i = from; i < to; i++) {
+            types[i] = type;
+        }
+    };
+
+    CORE_LOCK();
+    QString mnemonic;
+    {
+        ut8 buf[32];
+        RzAsmOp op;
+        rz_asm_op_init(&op);
+        rz_asm_set_pc(core->rasm, offset);
+        if (rz_io_read_at(core->io, offset, buf, sizeof(buf))
+            && rz_asm_disassemble(core->rasm, &op, buf, sizeof(buf)) > 0) {
+            mnemonic = QString(rz_asm_op_get_asm(&op)).section(QLatin1Char(' '), 0, 0);
+        }
+        rz_asm_op_fini(&op);
+    }
+
+    // The instruction follows the offset and bytes as a word of its own, before any comment
+    int commentStart = plain.indexOf(QLatin1Char(';'));
+    int asmStart = -1;
+    for (int i = mnemonic.isEmpty() ? -1 : plain.indexOf(mnemonic); i > 0;
+         i = plain.indexOf(mnemonic, i + 1)) {
+        int end = i + mnemonic.size();
+        if (commentStart >= 0 && i > commentStart) {
+            break;
+        }
+        if (plain[i - 1] == QLatin1Char(' ')
+            && (end == plain.size() || plain[end] == QLatin1Char(' '))) {
+            asmStart = i;
+            break;
+        }
+    }
+    int asmEnd = asmStart;
+    if (asmStart >= 0) {
+        asmEnd = commentStart > asmStart ? commentStart : plain.size();
+        while (asmEnd > asmStart && plain[asmEnd - 1] == QLatin1Char(' ')) {
+            asmEnd--;
+        }
+    }
+
+    // Offset of the line
+    int offsetEnd = asmStart >= 0 ? asmStart : commentStart >= 0 ? commentStart : plain.size();
+    int offsetStart = plain.indexOf(QLatin1String("0x"));
+    if (offsetStart >= 0 && offsetStart < offsetEnd) {
+        int end = offsetStart + 2;
+        while (end < offsetEnd && IS_HEXCHAR(plain[end].toLatin1())) {
+            end++;
+        }
+        setType(offsetStart, end, DisassemblyTokenType::Address);
+    }
+
+    if (asmStart >= 0) {
+        const QByteArray assembly = plain.mid(asmStart, asmEnd - asmStart).toUtf8();
+        RzStrBuf sb;
+        rz_strbuf_init(&sb);
+        rz_strbuf_set(&sb, assembly.constData());
+        RzAsmParseParam *param = rz_asm_get_parse_param(core->analysis->reg, 0);
+        RzAsmTokenString *tokens = rz_asm_tokenize_asm_string(&sb, param);
+        free(param);
+        rz_strbuf_fini(&sb);
+        if (tokens) {
+            void *it;
+            rz_vector_foreach(tokens->tokens, it)
+            {
+                auto token = reinterpret_cast<RzAsmToken *>(it);
+                // Token positions are in bytes of the UTF-8 text
+                int from = asmStart + QString::fromUtf8(assembly.constData(), token->start).size();
+                int to = from
+                        + QString::fromUtf8(assembly.constData() + token->start, token->len).size();
+                DisassemblyTokenType type = asmTokenType(token->type);
+                if (type == DisassemblyTokenType::Immediate) {
+                    bool ok;
+                    ut64 value = plain.mid(from, to - from).toULongLong(&ok, 0);
+                    if (ok && value && rz_io_is_valid_offset(core->io, value, 0)) {
+                        type = DisassemblyTokenType::Address;
+                    }
+                }
+                setType(from, std::min(to, asmEnd), type);
+            }
+            rz_asm_token_string_free(tokens);
+        }
+    }
+
+    if (commentStart >= 0 && commentStart >= asmEnd) {
+        setType(commentStart, plain.size(), DisassemblyTokenType::Comment);
+    }
+
+    // Split the colored runs where the type changes
+    QVector<DisassemblyTextRun> runs;
+    int pos = 0;
+    for (const DisassemblyTextRun &coloredRun : colored) {
+        const int size = coloredRun.text.size();
+        for (int start = 0; start < size;) {
+            DisassemblyTokenType type = types[pos + start];
+            int end = start + 1;
+            while (end < size && types[pos + end] == type) {
+                end++;
+            }
+            DisassemblyTextRun run = coloredRun;
+            run.text = coloredRun.text.mid(start, end - start);
+            run.type = type;
+            runs.push_back(run);
+            start = end;
+        }
+        pos += size;
+    }
+    return runs;
+}
+
+QVector<DisassemblyTextRun> CutterCore::ansiEscapeToRuns(const QString &text)
+{
+    QVector<DisassemblyTextRun> runs;
+    QString runText;
+    QColor color;
+    QColor background;
+    bool inverse = false;
+
+    auto finishRun = [&]() {
+        if (runText.isEmpty()) {
+            return;
+        }
+        DisassemblyTextRun run;
+        run.text = runText;
+        run.color = inverse ? background : color;
+        run.background = inverse ? color : background;
+        runs.push_back(run);
+        runText.clear();
+    };
+
+    std::vector<int> params;
+    const int length = text.length();
+    for (int i = 0; i < length; i++) {
+        QChar c = text[i];
+        if (c == QLatin1Char('\t')) {
+            runText += QLatin1String("        ");
+            continue;
+        }
+        if (c != QLatin1Char('\x1b')) {
+            runText += c;
+            continue;
+        }
+        if (i + 1 >= length || text[i + 1] != QLatin1Char('[')) {
+            continue;
+        }
+
+        // Control sequence: numeric parameters separated by ';' and a final character
+        params.clear();
+        int value = 0;
+        int j = i + 2;
+        for (; j < length; j++) {
+            ushort u = text[j].unicode();
+            if (u >= '0' && u <= '9') {
+                value = value * 10 + (u - '0');
+            } else if (u == ';') {
+                params.push_back(value);
+                value = 0;
+            } else if (u >= 0x40 && u <= 0x7e) {
+                break;
+            }
+        }
+        params.push_back(value);
+        i = j;
+        if (j >= length || text[j] != QLatin1Char('m')) {
+            continue;
+        }
+
+        finishRun();
+        for (size_t k = 0; k < params.size(); k++) {
+            int p = params[k];
+            if (p == 0) {
+                color = QColor();
+                background = QColor();
+                inverse = false;
+            } else if (p == 7) {
+                inverse = true;
+            } else if (p == 27) {
+                inverse = false;
+            } else if (p >= 30 && p <= 37) {
+                color = ansiColor(p - 30);
+            } else if (p >= 90 && p <= 97) {
+                color = ansiColor(p - 90 + 8);
+            } else if (p == 39) {
+                color = QColor();
+            } else if (p >= 40 && p <= 47) {
+                background = ansiColor(p - 40);
+            } else if (p >= 100 && p <= 107) {
+                background = ansiColor(p - 100 + 8);
+            } else if (p == 49) {
+                background = QColor();
+            } else if ((p == 38 || p == 48) && k + 1 < params.size()) {
+                QColor extended;
+                if (params[k + 1] == 5 && k + 2 < params.size()) {
+                    extended = ansiColor(params[k + 2]);
+                    k += 2;
+                } else if (params[k + 1] == 2 && k + 4 < params.size()) {
+                    extended = QColor(params[k + 2] & 0xff, params[k + 3] & 0xff,
+                                      params[k + 4] & 0xff);
+                    k += 4;
+                } else {
+                    break;
+                }
+                (p == 38 ? color : background) = extended;
+            }
+        }
+    }
+    finishRun();
+    return runs;
+}
+
 BasicBlockHighlighter *CutterCore::getBBHighlighter()
 {
     return bbHighlighter;
@@ -3,9 +3,15 @@
 
 #include "core/CutterCommon.h"
 #include "core/CutterDescriptions.h"
+#include "core/DescriptionColumns.h"
 #include "core/CutterJson.h"
 #include "core/Basefind.h"
+#include "core/DisassemblyLineCache.h"
+#include "core/InstructionBoundaryIndex.h"
+#include "core/ListDelta.h"
 #include "common/BasicInstructionHighlighter.h"
+#include "common/DecompilationCache.h"
+#include "common/RecursiveSharedMutex.h"
 
 #include <QMap>
 #include <QMenu>
@@ -16,7 +22,9 @@
 #include <QMessageBox>
 #include <QErrorMessage>
 #include <QMutex>
+#include <QSet>
 #include <QDir>
+#include <atomic>
 #include <functional>
 #include <memory>
 
@@ -24,6 +32,7 @@ class AsyncTaskManager;
 class BasicInstructionHighlighter;
 class CutterCore;
 class Decompiler;
+class DecompilerPrefetcher;
 class RizinTask;
 class RizinCmdTask;
 class RizinFunctionTask;
@@ -39,6 +48,10 @@ class RizinTaskDialog;
 
 class RzCoreLocked;
 
+using FunctionsDelta = ListDelta<RVA, FunctionDescription>;
+using FlagsDelta = ListDelta<QString, FlagDescription>;
+Q_DECLARE_METATYPE(FunctionsDelta)
+
 struct CUTTER_EXPORT AddrRefs
 {
     RVA addr;
@@ -142,6 +155,23 @@ public:
         return cmdRawAt(str.toUtf8().constData(), address);
     }
 
+    /**
+     * @brief Like cmdRaw(), for commands which only read, e.g. printing.
+     *
+     * cmdRaw() assumes the command may have changed anything and invalidates all cached
+     * disassembly, instruction boundaries and decompilations. This variant keeps them, so it
+     * must not be used for commands modifying the analysis, the memory or the configuration.
+     */
+    QString cmdRawReadOnly(const char *cmd);
+    /**
+     * @brief Like cmdRawAt(), for commands which only read. See cmdRawReadOnly().
+     */
+    QString cmdRawAtReadOnly(const char *cmd, RVA address);
+    QString cmdRawAtReadOnly(const QString &str, RVA address)
+    {
+        return cmdRawAtReadOnly(str.toUtf8().constData(), address);
+    }
+
     class SeekReturn
     {
         RVA returnAddress;
@@ -228,6 +258,11 @@ public:
     void delFlag(const QString &name);
     void addFlag(RVA offset, QString name, RVA size);
     QString listFlagsAsStringAt(RVA addr);
+    /**
+     * @brief Get all addresses in the inclusive range [start; end] which have a flag or a comment.
+     * @return sorted list without duplicates
+     */
+    QVector<RVA> getFlagAndCommentAddresses(RVA start, RVA end);
     /**
      * @brief Get nearest flag at or before offset.
      * @param offset search position
@@ -395,6 +430,19 @@ public:
     QString disassemble(const QByteArray &data);
     QString disassembleSingleInstruction(RVA addr);
     QList<DisassemblyLine> disassembleLines(RVA offset, int lines);
+    /**
+     * @brief Same as disassembleLines, but the lines are returned as colored runs instead of
+     * HTML, which can be drawn without parsing the text again.
+     */
+    QList<DisassemblyLine> disassembleLineRuns(RVA offset, int lines);
+    /**
+     * @brief Split a line of the disassembly of the instruction at \a offset into typed runs
+     *
+     * The instruction is tokenized by rizin, so its mnemonic, registers, numbers and separators
+     * get runs of their own. The offset and comments of the line are detected in the text.
+     * Colors are those of the theme.
+     */
+    QVector<DisassemblyTextRun> disassemblyTextRuns(RVA offset, const QString &text);
 
     static QByteArray hexStringToBytes(const QString &hex);
     static QString bytesToHexString(const QByteArray &bytes);
@@ -522,7 +570,20 @@ public:
     BreakpointDescription getBreakpointAt(RVA addr);
 
     bool isBreakpoint(const QList<RVA> &breakpoints, RVA addr);
+    bool isBreakpoint(RVA addr);
+    /**
+     * @brief Addresses of all breakpoints in ascending order
+     */
     QList<RVA> getBreakpointsAddresses();
+    /**
+     * @brief Addresses of all breakpoints, for views checking many addresses without locking the
+     * core each time
+     */
+    QSet<RVA> getBreakpointsAddressSet();
+    /**
+     * @brief Addresses of the breakpoints in [from; to) in ascending order
+     */
+    QList<RVA> getBreakpointsInRange(RVA from, RVA to);
 
     /**
      * @brief Get all breakpoinst that are belong to a functions at this address
@@ -558,6 +619,18 @@ public:
      */
     bool registerDecompiler(Decompiler *decompiler);
 
+    /**
+     * @brief Counter increased with every change which may affect decompiled code, like renames,
+     * type changes or commands
+     */
+    quint64 getAnalysisGeneration() const { return analysisGeneration; }
+    DecompilationCache *getDecompilationCache() { return &decompilationCache; }
+    /**
+     * @brief Background decompilation shared by all decompiler widgets, so a foreground
+     * decompilation in any of them cancels it
+     */
+    DecompilerPrefetcher *getDecompilerPrefetcher();
+
     RVA getOffsetJump(RVA addr);
     CutterJson getSignatureInfo();
     bool existsFileInfo();
@@ -586,6 +659,11 @@ public:
     QList<RzCorePluginDescription> getRCorePluginDescriptions();
     QList<RzAsmPluginDescription> getRAsmPluginDescriptions();
     QList<FunctionDescription> getAllFunctions();
+    /**
+     * @brief Functions added, changed or removed since an earlier call
+     * @param since generation of the last delta applied by the caller, 0 for all functions
+     */
+    FunctionsDelta getFunctionsDelta(quint64 since);
     QList<ImportDescription> getAllImports();
     QList<ExportDescription> getAllExports();
     QList<SymbolDescription> getAllSymbols();
@@ -595,8 +673,25 @@ public:
     QList<CommentDescription> getAllComments(const QString &filterType);
     QList<RelocDescription> getAllRelocs();
     QList<StringDescription> getAllStrings();
+    /**
+     * @brief Same as getAllStrings(), but stored in columns which take much less memory
+     */
+    StringDescriptionColumns getAllStringsColumns();
+    /**
+     * @brief Pass all strings to \a consumer in lists of up to \a chunkSize strings, in order
+     * @param consumer gets ownership of each list, returns false to stop
+     * @return false if the consumer stopped early
+     */
+    bool getAllStringsColumns(int chunkSize,
+                              const std::function<bool(StringDescriptionColumns &&)> &consumer);
     QList<FlagspaceDescription> getAllFlagspaces();
     QList<FlagDescription> getAllFlags(QString flagspace = QString());
+    /**
+     * @brief Flags of \a flagspace added, changed or removed since an earlier call for the same
+     * flagspace
+     * @param since generation of the last delta applied by the caller, 0 for all flags
+     */
+    FlagsDelta getFlagsDelta(quint64 since, const QString &flagspace = QString());
     QList<SectionDescription> getAllSections();
     QList<SegmentDescription> getAllSegments();
     QList<EntrypointDescription> getAllEntrypoint();
@@ -692,9 +787,35 @@ public:
 
     QStringList getSectionList();
 
+    /**
+     * @brief Lock the core for exclusive access.
+     */
     RzCoreLocked core();
 
+    /**
+     * @brief Lock the core for read-only access.
+     *
+     * Multiple threads may hold shared access at the same time. Only use it for code that doesn't
+     * modify the RzCore state in any way, including seeking and printing through RzCons, and never
+     * call anything requiring exclusive access while holding it.
+     */
+    RzCoreLocked coreShared();
+
+    /**
+     * @brief Counters of shared/exclusive core lock acquisitions and the time spent waiting for
+     * them.
+     */
+    SharedMutexStatistics getCoreLockStatistics();
+    void resetCoreLockStatistics();
+
     static QString ansiEscapeToHtml(const QString &text);
+    /**
+     * @brief Split text colored with ANSI escape sequences into runs of the same colors
+     *
+     * Tabs are expanded to 8 spaces like in ansiEscapeToHtml. Escape sequences other than colors
+     * are dropped.
+     */
+    static QVector<DisassemblyTextRun> ansiEscapeToRuns(const QString &text);
     BasicBlockHighlighter *getBBHighlighter();
     BasicInstructionHighlighter *getBIHighlighter();
 
@@ -758,11 +879,19 @@ signals:
     void functionRenamed(const RVA offset, const QString &new_name);
     void varsChanged();
     void globalVarsChanged();
+    /**
+     * @brief emitted after types were added, edited or removed
+     */
+    void typesChanged();
     void functionsChanged();
     void flagsChanged();
     void commentsChanged(RVA addr);
     void registersChanged();
-    void instructionChanged(RVA offset);
+    /**
+     * @brief Bytes or meta data changed at \a offset
+     * @param size number of bytes changed, the instructions following them may change as well
+     */
+    void instructionChanged(RVA offset, RVA size = 1);
     void breakpointsChanged(RVA offset);
     void refreshCodeViews();
     void stackChanged();
@@ -825,12 +954,7 @@ private:
      * NEVER use this directly! Always use the CORE_LOCK(); macro and access it like core->...
      */
     RzCore *core_ = nullptr;
-#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
-    QMutex coreMutex;
-#else
-    QRecursiveMutex coreMutex;
-#endif
-    int coreLockDepth = 0;
+    RecursiveSharedMutex coreMutex;
     void *coreBed = nullptr;
 
     AsyncTaskManager *asyncTaskManager;
@@ -839,6 +963,55 @@ private:
 
     QList<Decompiler *> decompilers;
 
+    /**
+     * @brief Lines returned by disassembleLines, shared by all code views
+     */
+    DisassemblyLineCache disassemblyCache { 32 * 1024 * 1024 };
+    /// Changes may also affect the instructions up to this many bytes after them
+    static constexpr RVA INSTRUCTION_CHANGE_RANGE = 0x100;
+
+    /**
+     * @brief Breakpoint addresses, rebuilt from rizin on first use after they changed
+     */
+    QSet<RVA> breakpointSet;
+    /// Same addresses in ascending order
+    QList<RVA> sortedBreakpoints;
+    bool breakpointIndexValid = false;
+
+    std::atomic<quint64> analysisGeneration { 0 };
+    DecompilationCache decompilationCache { 64 * 1024 * 1024 };
+    DecompilerPrefetcher *decompilerPrefetcher = nullptr;
+    /**
+     * @brief Instruction starts used by prevOpAddr, 1024 pages take about 0.5 MiB
+     */
+    InstructionBoundaryIndex instructionIndex {
+        1024, [this](RVA address, RVA from, InstructionBoundaryIndex::Page &page) {
+            return buildInstructionIndexPage(address, from, page);
+        }
+    };
+
+    /**
+     * @brief Last lists returned by getFunctionsDelta() and getFlagsDelta(), flags per flagspace
+     *
+     * The lists are only built again if the analysis generation changed since the last update.
+     */
+    QMutex listDeltaMutex;
+    ListDeltaTracker<RVA, FunctionDescription, &FunctionDescription::offset> functionsTracker;
+    quint64 functionsTrackerAnalysis = 0;
+    struct FlagsTracker
+    {
+        using Tracker = ListDeltaTracker<QString, FlagDescription, &FlagDescription::name>;
+        Tracker tracker;
+        quint64 analysisGeneration;
+    };
+    /// Only the flagspaces used most recently are tracked
+    static constexpr int MAX_FLAGS_TRACKERS = 4;
+    QHash<QString, FlagsTracker> flagsTrackers;
+    /// Flagspaces of flagsTrackers, least recently used first
+    QStringList flagsTrackersUse;
+    /// Latest generation of all flags trackers, including dropped ones
+    quint64 flagsTrackersGeneration = 0;
+
     bool emptyGraph = false;
     BasicBlockHighlighter *bbHighlighter;
     bool iocache = false;
@@ -847,6 +1020,23 @@ private:
     QSharedPointer<RizinTask> debugTask;
     RizinTaskDialog *debugTaskDialog;
 
+    enum class DisassemblyTextFormat { Html, Runs };
+    QList<DisassemblyLine> disassembleLines(RVA offset, int lines, DisassemblyTextFormat format);
+    /**
+     * @brief Hash of the options affecting the disassembly output, including the format
+     */
+    quint64 disassemblyOptionsKey(DisassemblyTextFormat format);
+    void invalidateDisassemblyCache();
+    void invalidateDisassemblyCache(RVA from, RVA to);
+    void connectDisassemblyCacheInvalidation();
+    bool buildInstructionIndexPage(RVA address, RVA from, InstructionBoundaryIndex::Page &page);
+    void updateBreakpointIndex();
+    void increaseAnalysisGeneration();
+    /**
+     * @brief Invalidate everything cached about the analysis after running an arbitrary command
+     */
+    void invalidateAfterCommand();
+
     QVector<QString> getCutterRCFilePaths() const;
     QList<TypeDescription> getBaseType(RzBaseTypeKind kind, const char *category);
 };
@@ -856,7 +1046,9 @@ class CUTTER_EXPORT RzCoreLocked
     CutterCore *const core;
 
 public:
-    explicit RzCoreLocked(CutterCore *core);
+    explicit RzCoreLocked(
+            CutterCore *core,
+            RecursiveSharedMutex::Mode mode = RecursiveSharedMutex::Mode::Exclusive);
     RzCoreLocked(const RzCoreLocked &) = delete;
     RzCoreLocked &operator=(const RzCoreLocked &) = delete;
     RzCoreLocked(RzCoreLocked &&);
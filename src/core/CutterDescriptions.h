@@ -7,6 +7,7 @@
 
 #include <QString>
 #include <QList>
+#include <QVector>
 #include <QStringList>
 #include <QMetaType>
 #include <QColor>
@@ -30,6 +31,13 @@ struct FunctionDescription
         // rz_analysis_function_contains() does it right.
         return addr >= offset && addr < offset + linearSize;
     }
+
+    bool operator==(const FunctionDescription &other) const
+    {
+        return offset == other.offset && linearSize == other.linearSize && nargs == other.nargs
+                && nbbs == other.nbbs && nlocals == other.nlocals && calltype == other.calltype
+                && name == other.name && edges == other.edges && stackframe == other.stackframe;
+    }
 };
 
 struct ImportDescription
@@ -131,6 +139,12 @@ struct FlagDescription
     RVA size;
     QString name;
     QString realname;
+
+    bool operator==(const FlagDescription &other) const
+    {
+        return offset == other.offset && size == other.size && name == other.name
+                && realname == other.realname;
+    }
 };
 
 struct SectionDescription
@@ -208,11 +222,44 @@ struct RzAsmPluginDescription
     QString license;
 };
 
+/**
+ * @brief What the text of a DisassemblyTextRun stands for
+ */
+enum class DisassemblyTokenType {
+    /// Anything without a more specific type, like bytes, arrows or padding
+    Text,
+    /// Offset of the line or a number in the operands which is a mapped address
+    Address,
+    Mnemonic,
+    Register,
+    /// Number in the operands which is not an address
+    Immediate,
+    /// Punctuation and operators between the operands
+    Separator,
+    Comment
+};
+
+/**
+ * @brief Part of a line of text drawn in the same colors
+ *
+ * Invalid colors stand for the default colors of the view.
+ */
+struct DisassemblyTextRun
+{
+    QString text;
+    QColor color;
+    QColor background;
+    DisassemblyTokenType type = DisassemblyTokenType::Text;
+};
+
 struct DisassemblyLine
 {
     RVA offset;
+    /// HTML, empty for lines returned by CutterCore::disassembleLineRuns()
     QString text;
     RVA arrow;
+    /// Colored text, only set by CutterCore::disassembleLineRuns()
+    QVector<DisassemblyTextRun> runs;
 };
 
 struct BinClassBaseClassDescription
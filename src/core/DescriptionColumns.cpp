@@ -0,0 +1,99 @@
+#include "DescriptionColumns.h"
+
+int StringInterner::id(const QString &string)
+{
+    auto it = ids.constFind(string);
+    if (it != ids.constEnd()) {
+        return it.value();
+    }
+    int id = values.size();
+    values.append(string);
+    ids.insert(string, id);
+    return id;
+}
+
+void StringInterner::clear()
+{
+    ids.clear();
+    values.clear();
+}
+
+void InternedColumn::clear()
+{
+    values.clear();
+    ids.clear();
+}
+
+void InternedColumn::append(const InternedColumn &other)
+{
+    if (ids.isEmpty()) {
+        *this = other;
+        return;
+    }
+    // Ids of the values of other in this column
+    QVector<int> otherIds;
+    otherIds.reserve(other.values.count());
+    for (int i = 0; i < other.values.count(); i++) {
+        otherIds.append(values.id(other.values.value(i)));
+    }
+    ids.reserve(ids.size() + other.ids.size());
+    for (int id : other.ids) {
+        ids.append(otherIds.at(id));
+    }
+}
+
+void StringDescriptionColumns::reserve(int size)
+{
+    vaddrs.reserve(size);
+    strings.reserve(size);
+    types.reserve(size);
+    sections.reserve(size);
+    lengths.reserve(size);
+    sizes.reserve(size);
+}
+
+void StringDescriptionColumns::clear()
+{
+    vaddrs.clear();
+    strings.clear();
+    types.clear();
+    sections.clear();
+    lengths.clear();
+    sizes.clear();
+}
+
+void StringDescriptionColumns::append(const StringDescription &string)
+{
+    vaddrs.append(string.vaddr);
+    strings.append(string.string);
+    types.append(string.type);
+    sections.append(string.section);
+    lengths.append(string.length);
+    sizes.append(string.size);
+}
+
+void StringDescriptionColumns::append(const StringDescriptionColumns &other)
+{
+    if (isEmpty()) {
+        *this = other;
+        return;
+    }
+    vaddrs += other.vaddrs;
+    strings += other.strings;
+    types.append(other.types);
+    sections.append(other.sections);
+    lengths += other.lengths;
+    sizes += other.sizes;
+}
+
+StringDescription StringDescriptionColumns::at(int row) const
+{
+    StringDescription string;
+    string.vaddr = vaddrs.at(row);
+    string.string = strings.at(row);
+    string.type = types.at(row);
+    string.section = sections.at(row);
+    string.length = lengths.at(row);
+    string.size = sizes.at(row);
+    return string;
+}
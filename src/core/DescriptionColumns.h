@@ -0,0 +1,118 @@
+#ifndef DESCRIPTIONCOLUMNS_H
+#define DESCRIPTIONCOLUMNS_H
+
+#include "core/CutterCommon.h"
+#include "core/CutterDescriptions.h"
+
+#include <QHash>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Shares the data of equal strings
+ *
+ * Lists describing many items often repeat a few texts like types or section names in every
+ * item. Passing them through intern() makes all copies share the data of the first one.
+ */
+class CUTTER_EXPORT StringInterner
+{
+public:
+    /**
+     * @return \a string sharing the data of an equal string interned before
+     */
+    QString intern(const QString &string) { return value(id(string)); }
+
+    /**
+     * @return number identifying \a string, equal strings get the same id
+     */
+    int id(const QString &string);
+    /**
+     * @return id of \a string, -1 if it has not been interned
+     */
+    int findId(const QString &string) const { return ids.value(string, -1); }
+    const QString &value(int id) const { return values.at(id); }
+    int count() const { return values.size(); }
+    void clear();
+
+private:
+    QHash<QString, int> ids;
+    QVector<QString> values;
+};
+
+/**
+ * @brief Column of a text with few distinct values, each row stores only the id of its value
+ */
+class CUTTER_EXPORT InternedColumn
+{
+public:
+    int size() const { return ids.size(); }
+    void reserve(int size) { ids.reserve(size); }
+    void clear();
+
+    void append(const QString &value) { ids.append(values.id(value)); }
+    /**
+     * @brief Append all rows of \a other
+     */
+    void append(const InternedColumn &other);
+
+    const QString &at(int row) const { return values.value(ids.at(row)); }
+    /**
+     * @return id of the value of \a row, rows with the same value have the same id
+     */
+    int valueId(int row) const { return ids.at(row); }
+    /**
+     * @return id of \a value, -1 if no row has it
+     */
+    int findValueId(const QString &value) const { return values.findId(value); }
+
+private:
+    StringInterner values;
+    QVector<int> ids;
+};
+
+/**
+ * @brief List of StringDescription stored as one array per member
+ *
+ * Types and sections are interned, so each row takes a few bytes for them instead of its own
+ * strings. The columns are implicitly shared like Qt containers, so copying the list or passing
+ * it through a queued connection is cheap.
+ */
+class CUTTER_EXPORT StringDescriptionColumns
+{
+public:
+    int size() const { return vaddrs.size(); }
+    bool isEmpty() const { return vaddrs.isEmpty(); }
+    void reserve(int size);
+    void clear();
+
+    void append(const StringDescription &string);
+    /**
+     * @brief Append all rows of \a other, sharing its columns if this list is empty
+     */
+    void append(const StringDescriptionColumns &other);
+
+    /**
+     * @brief Assemble the description of \a row
+     */
+    StringDescription at(int row) const;
+
+    RVA vaddrAt(int row) const { return vaddrs.at(row); }
+    const QString &stringAt(int row) const { return strings.at(row); }
+    const QString &typeAt(int row) const { return types.at(row); }
+    const QString &sectionAt(int row) const { return sections.at(row); }
+    ut32 lengthAt(int row) const { return lengths.at(row); }
+    ut32 sizeAt(int row) const { return sizes.at(row); }
+
+private:
+    QVector<RVA> vaddrs;
+    QVector<QString> strings;
+    InternedColumn types;
+    InternedColumn sections;
+    QVector<ut32> lengths;
+    QVector<ut32> sizes;
+};
+
+Q_DECLARE_METATYPE(StringDescriptionColumns)
+
+#endif // DESCRIPTIONCOLUMNS_H
@@ -0,0 +1,74 @@
+#include "DisassemblyLineCache.h"
+
+DisassemblyLineCache::DisassemblyLineCache(size_t maxBytes) : maxBytes(maxBytes) {}
+
+const DisassemblyLineCache::Instruction *DisassemblyLineCache::find(quint64 optionsKey, RVA addr)
+{
+    auto it = entries.find({ addr, optionsKey });
+    if (it == entries.end()) {
+        return nullptr;
+    }
+    lru.splice(lru.begin(), lru, it->second.lruPos);
+    return &it->second.instruction;
+}
+
+void DisassemblyLineCache::insert(quint64 optionsKey, RVA addr, Instruction instruction)
+{
+    Key key(addr, optionsKey);
+    auto old = entries.find(key);
+    if (old != entries.end()) {
+        remove(old);
+    }
+
+    size_t bytes = estimateBytes(instruction);
+    lru.push_front(key);
+    Entry entry { std::move(instruction), bytes, lru.begin() };
+    entries.emplace(key, std::move(entry));
+    usedBytes += bytes;
+
+    while (usedBytes > maxBytes && !lru.empty()) {
+        remove(entries.find(lru.back()));
+    }
+}
+
+void DisassemblyLineCache::invalidate()
+{
+    entries.clear();
+    lru.clear();
+    usedBytes = 0;
+}
+
+void DisassemblyLineCache::invalidate(RVA from, RVA to)
+{
+    const RVA maxSpan = MAX_INSTRUCTION_SPAN;
+    RVA first = from > maxSpan ? from - maxSpan : 0;
+    auto it = entries.lower_bound({ first, 0 });
+    while (it != entries.end() && it->first.first < to) {
+        auto next = std::next(it);
+        RVA end = it->second.instruction.next;
+        // The next address wraps around for the last instruction of the address space
+        if (end > from || end <= it->first.first) {
+            remove(it);
+        }
+        it = next;
+    }
+}
+
+void DisassemblyLineCache::remove(std::map<Key, Entry>::iterator it)
+{
+    usedBytes -= it->second.bytes;
+    lru.erase(it->second.lruPos);
+    entries.erase(it);
+}
+
+size_t DisassemblyLineCache::estimateBytes(const Instruction &instruction)
+{
+    size_t bytes = sizeof(Entry) + sizeof(Key) * 2;
+    for (const DisassemblyLine &line : instruction.lines) {
+        bytes += sizeof(DisassemblyLine) + line.text.size() * sizeof(QChar);
+        for (const DisassemblyTextRun &run : line.runs) {
+            bytes += sizeof(DisassemblyTextRun) + run.text.size() * sizeof(QChar);
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,68 @@
+#ifndef DISASSEMBLYLINECACHE_H
+#define DISASSEMBLYLINECACHE_H
+
+#include "core/CutterDescriptions.h"
+
+#include <list>
+#include <map>
+#include <utility>
+
+/**
+ * @brief Disassembly lines already produced by rizin, grouped by instruction.
+ *
+ * Each instruction is stored together with a key describing everything else the output depends
+ * on, like the options and the text format, so views with different settings don't evict each
+ * other. Entries are evicted in LRU order once their estimated size exceeds the budget.
+ *
+ * Not thread safe, CutterCore only accesses it while holding the core lock.
+ */
+class DisassemblyLineCache
+{
+public:
+    struct Instruction
+    {
+        /// All lines printed for the instruction, including flags and comments above it
+        QList<DisassemblyLine> lines;
+        /// Address of the next instruction
+        RVA next;
+    };
+
+    explicit DisassemblyLineCache(size_t maxBytes);
+
+    /**
+     * @return the cached instruction or nullptr, the pointer is valid until the next insert or
+     * invalidate call
+     */
+    const Instruction *find(quint64 optionsKey, RVA addr);
+    void insert(quint64 optionsKey, RVA addr, Instruction instruction);
+
+    void invalidate();
+    /**
+     * @brief Remove all instructions overlapping with [from; to)
+     */
+    void invalidate(RVA from, RVA to);
+
+private:
+    /// Address first, so the instructions in a range are next to each other
+    using Key = std::pair<RVA, quint64>;
+
+    struct Entry
+    {
+        Instruction instruction;
+        size_t bytes;
+        std::list<Key>::iterator lruPos;
+    };
+
+    /// Instructions starting this far before the invalidated range are checked for overlap
+    static constexpr RVA MAX_INSTRUCTION_SPAN = 0x100;
+
+    void remove(std::map<Key, Entry>::iterator it);
+    static size_t estimateBytes(const Instruction &instruction);
+
+    std::map<Key, Entry> entries;
+    std::list<Key> lru; ///< Most recently used first
+    size_t usedBytes = 0;
+    size_t maxBytes;
+};
+
+#endif // DISASSEMBLYLINECACHE_H
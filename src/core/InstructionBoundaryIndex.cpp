@@ -0,0 +1,124 @@
+#include "InstructionBoundaryIndex.h"
+
+InstructionBoundaryIndex::InstructionBoundaryIndex(int maxPages, Builder builder)
+    : maxPages(maxPages), builder(std::move(builder))
+{
+}
+
+RVA InstructionBoundaryIndex::prevInstruction(RVA addr, int count)
+{
+    const RVA pageSize = PAGE_BYTES;
+    RVA end = addr;
+    for (int i = 0; i < MAX_LOOKBACK_PAGES && end > 0; i++) {
+        RVA address = (end - 1) & ~(pageSize - 1);
+        const Page *page = getPage(address);
+        if (!page) {
+            return RVA_INVALID;
+        }
+        for (RVA offset = end - address; offset > 0; offset--) {
+            if (page->starts[offset - 1] && --count <= 0) {
+                return address + offset - 1;
+            }
+        }
+        end = address;
+    }
+    return RVA_INVALID;
+}
+
+const InstructionBoundaryIndex::Page *InstructionBoundaryIndex::getPage(RVA address)
+{
+    auto it = pages.find(address);
+    if (it != pages.end() && it->page.anchored) {
+        lru.splice(lru.begin(), lru, it->lruPos);
+        return &it->page;
+    }
+
+    // Continue the sweep of the previous page, it is built without its own predecessor
+    RVA from = RVA_INVALID;
+    const RVA pageSize = PAGE_BYTES;
+    if (address >= pageSize) {
+        auto prev = pages.find(address - pageSize);
+        const Page *prevPage = prev != pages.end() ? &prev->page
+                                                   : buildPage(address - pageSize, RVA_INVALID);
+        if (prevPage) {
+            from = prevPage->next;
+        }
+    }
+
+    it = pages.find(address);
+    if (it != pages.end() && from == RVA_INVALID) {
+        lru.splice(lru.begin(), lru, it->lruPos);
+        return &it->page;
+    }
+    return buildPage(address, from);
+}
+
+const InstructionBoundaryIndex::Page *InstructionBoundaryIndex::buildPage(RVA address, RVA from)
+{
+    Page page;
+    if (!builder(address, from, page)) {
+        return nullptr;
+    }
+
+    auto old = pages.find(address);
+    if (old != pages.end()) {
+        if (old->page.next != page.next) {
+            // The following page was swept from the old end
+            auto following = pages.find(address + PAGE_BYTES);
+            if (following != pages.end()) {
+                remove(following);
+            }
+        }
+        remove(pages.find(address));
+    }
+
+    while (pages.size() >= maxPages && !lru.empty()) {
+        remove(pages.find(lru.back()));
+    }
+    lru.push_front(address);
+    auto it = pages.insert(address, Entry { page, lru.begin() });
+    return &it->page;
+}
+
+void InstructionBoundaryIndex::invalidate()
+{
+    pages.clear();
+    lru.clear();
+}
+
+void InstructionBoundaryIndex::invalidate(RVA from, RVA to)
+{
+    const RVA pageSize = PAGE_BYTES;
+    // An instruction of the previous page may reach into the range and sweeps continue into the
+    // next page
+    RVA first = (from & ~(pageSize - 1));
+    first = first >= pageSize ? first - pageSize : 0;
+    RVA last = ((to > 0 ? to - 1 : 0) & ~(pageSize - 1));
+    last = last <= RVA_MAX - pageSize ? last + pageSize : last;
+    if ((last - first) / pageSize >= static_cast<RVA>(pages.size())) {
+        for (auto it = pages.begin(); it != pages.end();) {
+            if (it.key() >= first && it.key() <= last) {
+                lru.erase(it->lruPos);
+                it = pages.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return;
+    }
+    for (RVA address = first;; address += pageSize) {
+        auto it = pages.find(address);
+        if (it != pages.end()) {
+            remove(it);
+        }
+        if (address == last) {
+            break;
+        }
+    }
+}
+
+void InstructionBoundaryIndex::remove(QHash<RVA, Entry>::iterator it)
+{
+    lru.erase(it->lruPos);
+    pages.erase(it);
+}
@@ -0,0 +1,82 @@
+#ifndef INSTRUCTIONBOUNDARYINDEX_H
+#define INSTRUCTIONBOUNDARYINDEX_H
+
+#include "core/CutterCommon.h"
+
+#include <QHash>
+
+#include <bitset>
+#include <functional>
+#include <list>
+
+/**
+ * @brief Addresses at which instructions start, stored as one bitmap per page.
+ *
+ * Finding the instruction before an address by disassembling backwards is slow and often
+ * misaligned on variable-length architectures. Pages are built lazily by a builder function,
+ * usually from the analysis basic blocks and a linear sweep over the rest, so looking back only
+ * has to scan the bitmaps. Pages are evicted in LRU order.
+ *
+ * A sweep continues where the sweep of the previous page stopped, so a page is built together
+ * with its predecessor when needed. Not thread safe, CutterCore only accesses it while holding the
+ * core lock.
+ */
+class InstructionBoundaryIndex
+{
+public:
+    static constexpr RVA PAGE_BYTES = 0x1000;
+
+    struct Page
+    {
+        /// Bit i is set if an instruction starts at page address + i
+        std::bitset<PAGE_BYTES> starts;
+        /// Start of the first instruction at or after the end of the page
+        RVA next = RVA_INVALID;
+        /// Whether the sweep started at a known instruction instead of a guess
+        bool anchored = false;
+    };
+
+    /**
+     * @brief Fills a page
+     * @param address start of the page
+     * @param from where the first instruction of the page starts, RVA_INVALID if unknown
+     * @return false if there is no code to index at address
+     */
+    using Builder = std::function<bool(RVA address, RVA from, Page &page)>;
+
+    InstructionBoundaryIndex(int maxPages, Builder builder);
+
+    /**
+     * @brief Find the start of the count-th instruction before addr
+     * @return RVA_INVALID if the instructions are not known, e.g. because they are in unmapped
+     * memory or too far away
+     */
+    RVA prevInstruction(RVA addr, int count);
+
+    void invalidate();
+    /**
+     * @brief Remove all pages which may depend on the bytes and meta data in [from; to)
+     */
+    void invalidate(RVA from, RVA to);
+
+private:
+    struct Entry
+    {
+        Page page;
+        std::list<RVA>::iterator lruPos;
+    };
+
+    /// Looking further back than this is left to the disassembler
+    static constexpr int MAX_LOOKBACK_PAGES = 16;
+
+    const Page *getPage(RVA address);
+    const Page *buildPage(RVA address, RVA from);
+    void remove(QHash<RVA, Entry>::iterator it);
+
+    QHash<RVA, Entry> pages;
+    std::list<RVA> lru; ///< Most recently used first
+    int maxPages;
+    Builder builder;
+};
+
+#endif // INSTRUCTIONBOUNDARYINDEX_H
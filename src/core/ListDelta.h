@@ -0,0 +1,139 @@
+#ifndef LISTDELTA_H
+#define LISTDELTA_H
+
+#include <QHash>
+#include <QList>
+
+/**
+ * @brief Changes of a list of keyed items since a generation, as returned by ListDeltaTracker
+ */
+template<typename Key, typename Value>
+struct ListDelta
+{
+    /// Generation of the list including these changes, pass it to the next request
+    quint64 generation = 0;
+    /// The changes could not be determined, updated holds the whole list
+    bool reset = false;
+    /// Added or changed items, in list order
+    QList<Value> updated;
+    QList<Key> removed;
+
+    bool isEmpty() const { return !reset && updated.isEmpty() && removed.isEmpty(); }
+};
+
+/**
+ * @brief Tracks a list of items identified by \a KeyMember to tell consumers what changed
+ *
+ * Every update() which changes the list increases the generation and stamps the added, changed
+ * and removed items with it. A consumer passes the generation of the last delta it applied and
+ * gets only the items stamped later, so it can update its rows instead of resetting. Removed keys
+ * are remembered up to maxRemoved, consumers older than that get the whole list again.
+ *
+ * Value needs operator== to detect changed items. The tracker is not thread-safe.
+ */
+template<typename Key, typename Value, Key Value::*KeyMember>
+class ListDeltaTracker
+{
+public:
+    /**
+     * @param firstGeneration generation to start with. Consumers passing an older one get the
+     * whole list, so a tracker replacing another one starts after its last generation.
+     */
+    explicit ListDeltaTracker(int maxRemoved = 4096, quint64 firstGeneration = 0)
+        : maxRemoved(maxRemoved), generation(firstGeneration), forgottenBefore(firstGeneration)
+    {
+    }
+
+    quint64 getGeneration() const { return generation; }
+
+    /**
+     * @brief Get the delta without update() if the list is known to be unchanged since then
+     * @return false if the consumer misses changes and needs update()
+     */
+    bool unchangedDelta(quint64 since, ListDelta<Key, Value> &delta) const
+    {
+        if (since == 0 || since != generation) {
+            return false;
+        }
+        delta = ListDelta<Key, Value>();
+        delta.generation = generation;
+        return true;
+    }
+
+    /**
+     * @brief Replace the tracked list with \a current
+     * @param since generation of the last delta applied by the consumer, 0 if it has nothing
+     * @return changes of \a current since \a since
+     */
+    ListDelta<Key, Value> update(const QList<Value> &current, quint64 since)
+    {
+        quint64 next = generation + 1;
+        bool changed = false;
+        QHash<Key, Entry> newEntries;
+        newEntries.reserve(current.size());
+        for (const Value &value : current) {
+            const Key &key = value.*KeyMember;
+            auto old = entries.constFind(key);
+            quint64 stamp = next;
+            if (old == entries.constEnd()) {
+                removed.remove(key);
+                changed = true;
+            } else if (!(old->value == value)) {
+                changed = true;
+            } else {
+                stamp = old->generation;
+            }
+            newEntries.insert(key, Entry { value, stamp });
+        }
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+            if (!newEntries.contains(it.key())) {
+                removed.insert(it.key(), next);
+                changed = true;
+            }
+        }
+        entries.swap(newEntries);
+        if (changed) {
+            generation = next;
+        }
+        if (removed.size() > maxRemoved) {
+            removed.clear();
+            forgottenBefore = generation;
+        }
+
+        ListDelta<Key, Value> delta;
+        delta.generation = generation;
+        if (since == 0 || since < forgottenBefore || since > generation) {
+            delta.reset = true;
+            delta.updated = current;
+            return delta;
+        }
+        for (const Value &value : current) {
+            if (entries.constFind(value.*KeyMember)->generation > since) {
+                delta.updated.append(value);
+            }
+        }
+        for (auto it = removed.constBegin(); it != removed.constEnd(); ++it) {
+            if (it.value() > since) {
+                delta.removed.append(it.key());
+            }
+        }
+        return delta;
+    }
+
+private:
+    struct Entry
+    {
+        Value value;
+        quint64 generation;
+    };
+
+    int maxRemoved;
+    quint64 generation = 0;
+    /// Deltas since generations before this can't be computed, removed keys have been dropped
+    quint64 forgottenBefore = 0;
+    QHash<Key, Entry> entries;
+    /// Generation in which each key has been removed
+    QHash<Key, quint64> removed;
+};
+
+#endif // LISTDELTA_H
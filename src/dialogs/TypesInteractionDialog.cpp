@@ -80,6 +80,7 @@ void TypesInteractionDialog::done(int r)
             }
         }
         if (success) {
+            emit Core()->typesChanged();
             emit newTypesLoaded();
             QDialog::done(r);
             return;
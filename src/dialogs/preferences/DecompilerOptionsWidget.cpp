@@ -0,0 +1,38 @@
+#include "DecompilerOptionsWidget.h"
+#include "ui_DecompilerOptionsWidget.h"
+
+#include "PreferencesDialog.h"
+
+#include "common/Configuration.h"
+
+DecompilerOptionsWidget::DecompilerOptionsWidget(PreferencesDialog *dialog)
+    : QDialog(dialog), ui(new Ui::DecompilerOptionsWidget)
+{
+    ui->setupUi(this);
+
+    ui->prefetchLimitSpinBox->setValue(Config()->getDecompilerPrefetchLimit());
+    ui->prefetchTimeBudgetSpinBox->setValue(Config()->getDecompilerPrefetchTimeBudget());
+    ui->prefetchCpuShareSpinBox->setValue(Config()->getDecompilerPrefetchCpuShare());
+    updatePrefetchEnabled();
+
+    connect<void (QSpinBox::*)(int)>(ui->prefetchLimitSpinBox, &QSpinBox::valueChanged, this,
+                                     [this](int functions) {
+                                         Config()->setDecompilerPrefetchLimit(functions);
+                                         updatePrefetchEnabled();
+                                     });
+    connect<void (QSpinBox::*)(int)>(
+            ui->prefetchTimeBudgetSpinBox, &QSpinBox::valueChanged, this,
+            [](int seconds) { Config()->setDecompilerPrefetchTimeBudget(seconds); });
+    connect<void (QSpinBox::*)(int)>(
+            ui->prefetchCpuShareSpinBox, &QSpinBox::valueChanged, this,
+            [](int percent) { Config()->setDecompilerPrefetchCpuShare(percent); });
+}
+
+DecompilerOptionsWidget::~DecompilerOptionsWidget() {}
+
+void DecompilerOptionsWidget::updatePrefetchEnabled()
+{
+    bool enabled = ui->prefetchLimitSpinBox->value() > 0;
+    ui->prefetchTimeBudgetSpinBox->setEnabled(enabled);
+    ui->prefetchCpuShareSpinBox->setEnabled(enabled);
+}
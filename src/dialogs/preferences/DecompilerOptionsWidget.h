@@ -0,0 +1,33 @@
+#ifndef DECOMPILEROPTIONSWIDGET_H
+#define DECOMPILEROPTIONSWIDGET_H
+
+#include <QDialog>
+#include <memory>
+
+#include "core/Cutter.h"
+
+class PreferencesDialog;
+
+namespace Ui {
+class DecompilerOptionsWidget;
+}
+
+class DecompilerOptionsWidget : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DecompilerOptionsWidget(PreferencesDialog *dialog);
+    ~DecompilerOptionsWidget();
+
+private:
+    std::unique_ptr<Ui::DecompilerOptionsWidget> ui;
+
+private slots:
+    /**
+     * @brief Enable the budget options only while background decompilation is enabled
+     */
+    void updatePrefetchEnabled();
+};
+
+#endif // DECOMPILEROPTIONSWIDGET_H
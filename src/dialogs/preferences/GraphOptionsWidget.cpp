@@ -49,6 +49,14 @@ void GraphOptionsWidget::updateOptionsFromVars()
     ui->minFontSizeSpinBox->blockSignals(true);
     ui->minFontSizeSpinBox->setValue(Config()->getGraphMinFontSize());
     ui->minFontSizeSpinBox->blockSignals(false);
+    ui->simplifiedBlockZoomSpinBox->blockSignals(true);
+    ui->simplifiedBlockZoomSpinBox->setValue(Config()->getGraphSimplifiedBlockZoom());
+    ui->simplifiedBlockZoomSpinBox->blockSignals(false);
+    ui->simplifiedEdgeZoomSpinBox->blockSignals(true);
+    ui->simplifiedEdgeZoomSpinBox->setValue(Config()->getGraphSimplifiedEdgeZoom());
+    ui->simplifiedEdgeZoomSpinBox->blockSignals(false);
+    qhelpers::setCheckedWithoutSignals(ui->simplifiedBlockTitleCheckBox,
+                                       Config()->getGraphSimplifiedBlockTitle());
     auto blockSpacing = Config()->getGraphBlockSpacing();
     ui->horizontalBlockSpacing->setValue(blockSpacing.x());
     ui->verticalBlockSpacing->setValue(blockSpacing.y());
@@ -78,6 +86,24 @@ void GraphOptionsWidget::on_minFontSizeSpinBox_valueChanged(int value)
     triggerOptionsChanged();
 }
 
+void GraphOptionsWidget::on_simplifiedBlockZoomSpinBox_valueChanged(int value)
+{
+    Config()->setGraphSimplifiedBlockZoom(value);
+    triggerOptionsChanged();
+}
+
+void GraphOptionsWidget::on_simplifiedEdgeZoomSpinBox_valueChanged(int value)
+{
+    Config()->setGraphSimplifiedEdgeZoom(value);
+    triggerOptionsChanged();
+}
+
+void GraphOptionsWidget::on_simplifiedBlockTitleCheckBox_toggled(bool checked)
+{
+    Config()->setGraphSimplifiedBlockTitle(checked);
+    triggerOptionsChanged();
+}
+
 void GraphOptionsWidget::on_graphOffsetCheckBox_toggled(bool checked)
 {
     Config()->setConfig("graph.offset", checked);
@@ -32,6 +32,9 @@ private slots:
 
     void on_maxColsSpinBox_valueChanged(int value);
     void on_minFontSizeSpinBox_valueChanged(int value);
+    void on_simplifiedBlockZoomSpinBox_valueChanged(int value);
+    void on_simplifiedEdgeZoomSpinBox_valueChanged(int value);
+    void on_simplifiedBlockTitleCheckBox_toggled(bool checked);
     void on_graphOffsetCheckBox_toggled(bool checked);
     void on_graphPreviewCheckBox_toggled(bool checked);
 
@@ -8,6 +8,7 @@
 #include "PluginsOptionsWidget.h"
 #include "InitializationFileEditor.h"
 #include "AnalysisOptionsWidget.h"
+#include "DecompilerOptionsWidget.h"
 
 #include "PreferenceCategory.h"
 
@@ -36,7 +37,8 @@ PreferencesDialog::PreferencesDialog(QWidget *parent)
         { tr("Plugins"), new PluginsOptionsWidget(this), QIcon(":/img/icons/plugins.svg") },
         { tr("Initialization Script"), new InitializationFileEditor(this),
           QIcon(":/img/icons/initialization.svg") },
-        { tr("Analysis"), new AnalysisOptionsWidget(this), QIcon(":/img/icons/cog_light.svg") }
+        { tr("Analysis"), new AnalysisOptionsWidget(this), QIcon(":/img/icons/cog_light.svg") },
+        { tr("Decompiler"), new DecompilerOptionsWidget(this), QIcon(":/img/icons/cog_light.svg") }
     };
 
     for (auto &c : prefs) {
@@ -96,6 +98,7 @@ void PreferencesDialog::chooseThemeIcons()
         { QStringLiteral("Plugins"), QStringLiteral("plugins.svg") },
         { QStringLiteral("Initialization Script"), QStringLiteral("initialization.svg") },
         { QStringLiteral("Analysis"), QStringLiteral("cog_light.svg") },
+        { QStringLiteral("Decompiler"), QStringLiteral("cog_light.svg") },
     };
     QList<QPair<void *, QString>> supportedIconsNames;
 
@@ -36,6 +36,7 @@ CutterGraphView::CutterGraphView(QWidget *parent)
 
     initFont();
     updateColors();
+    updateDetailLevelScales();
 
     connect(&actionExportGraph, &QAction::triggered, this, &CutterGraphView::showExportDialog);
 
@@ -190,6 +191,12 @@ GraphLayout::LayoutConfig CutterGraphView::getLayoutConfig()
     return layoutConfig;
 }
 
+void CutterGraphView::updateDetailLevelScales()
+{
+    setDetailLevelScales(Config()->getGraphSimplifiedBlockZoom() / 100.0,
+                         Config()->getGraphSimplifiedEdgeZoom() / 100.0);
+}
+
 void CutterGraphView::updateLayout()
 {
     setGraphLayout(GraphView::makeGraphLayout(graphLayout, horizontalLayoutAction->isChecked()));
@@ -244,6 +251,7 @@ void CutterGraphView::refreshView()
 {
     initFont();
     setLayoutConfig(getLayoutConfig());
+    updateDetailLevelScales();
 }
 
 bool CutterGraphView::gestureEvent(QGestureEvent *event)
@@ -110,6 +110,7 @@ protected:
     void initFont();
     QPoint getTextOffset(int line) const;
     GraphLayout::LayoutConfig getLayoutConfig();
+    void updateDetailLevelScales();
     virtual void updateLayout();
 
     // Font data
@@ -14,7 +14,10 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
 #include <QLayoutItem>
+#include <QPushButton>
 #include <QString>
 #include <QMessageBox>
 #include <QDialog>
@@ -27,7 +30,10 @@ Dashboard::Dashboard(MainWindow *main) : CutterDockWidget(main), ui(new Ui::Dash
     connect(Core(), &CutterCore::refreshAll, this, &Dashboard::updateContents);
 }
 
-Dashboard::~Dashboard() {}
+Dashboard::~Dashboard()
+{
+    cancelHashes();
+}
 
 void Dashboard::updateContents()
 {
@@ -81,38 +87,20 @@ void Dashboard::updateContents()
     int static_value = rz_bin_is_static(core->bin);
     setPlainText(ui->staticEdit, tr(setBoolText(static_value)));
 
-    const RzPVector *hashes = bf ? rz_bin_file_compute_hashes(core->bin, bf, UT64_MAX) : nullptr;
-
-    // Delete hashesWidget if it isn't null to avoid duplicate components
-    if (hashesWidget) {
-        hashesWidget->deleteLater();
-    }
-
-    // Define dynamic components to hold the hashes
-    hashesWidget = new QWidget();
-    QFormLayout *hashesLayout = new QFormLayout;
-    hashesWidget->setLayout(hashesLayout);
-    ui->hashesVerticalLayout->addWidget(hashesWidget);
-
-    // Add hashes as a pair of Hash Name : Hash Value.
-    if (hashes != nullptr) {
-        for (const auto &hash : CutterPVector<RzBinFileHash>(hashes)) {
-            // Create a bold QString with the hash name uppercased
-            QString label = QString("<b>%1:</b>").arg(QString(hash->type).toUpper());
-
-            // Define a Read-Only line edit to display the hash value
-            QLineEdit *hashLineEdit = new QLineEdit();
-            hashLineEdit->setReadOnly(true);
-            hashLineEdit->setText(hash->hex);
-
-            // Set cursor position to begining to avoid long hashes (e.g sha256)
-            // to look truncated at the begining
-            hashLineEdit->setCursorPosition(0);
-
-            // Add both controls to a form layout in a single row
-            hashesLayout->addRow(new QLabel(label), hashLineEdit);
-        }
+    // Identify the file by uri, size and modification time for the hashes cache
+    QString hashesIdentity;
+    RzIODesc *bfDesc = bf ? rz_io_desc_get(core->io, bf->fd) : nullptr;
+    if (bfDesc && bfDesc->uri) {
+        QString uri = QString::fromUtf8(bfDesc->uri);
+        QFileInfo fileInfo(uri);
+        hashesIdentity = QStringLiteral("%1:%2:%3")
+                                 .arg(uri)
+                                 .arg(rz_io_desc_size(bfDesc))
+                                 .arg(fileInfo.isFile()
+                                              ? fileInfo.lastModified().toMSecsSinceEpoch()
+                                              : qint64(bf->fd));
     }
+    updateHashes(bf ? bf->fd : -1, hashesIdentity);
 
     st64 fcns = rz_list_length(core->analysis->fcns);
     st64 strs = rz_flag_count(core->flags, "str.*");
@@ -156,6 +144,109 @@ void Dashboard::updateContents()
     ui->versioninfoButton->setEnabled(Core()->existsFileInfo());
 }
 
+void Dashboard::updateHashes(int fd, const QString &identity)
+{
+    if (hashesTask && hashesTask->getIdentity() != identity) {
+        cancelHashes();
+    }
+
+    QFormLayout *hashesLayout = resetHashesWidget();
+    if (identity.isEmpty()) {
+        return;
+    }
+
+    auto cached = hashesCache.constFind(identity);
+    if (cached != hashesCache.constEnd()) {
+        showHashes(cached.value());
+        return;
+    }
+
+    hashesProgressLabel = new QLabel(tr("Computing hashes..."));
+    auto cancelButton = new QPushButton(tr("Cancel"));
+    connect(cancelButton, &QPushButton::clicked, this, [this]() {
+        cancelHashes();
+        if (hashesProgressLabel) {
+            hashesProgressLabel->setText(tr("Hash computation cancelled"));
+        }
+    });
+    hashesLayout->addRow(hashesProgressLabel, cancelButton);
+
+    if (hashesTask) {
+        // Already computing the hashes of this file
+        return;
+    }
+    hashesTask = QSharedPointer<FileHashesTask>(new FileHashesTask(fd, identity));
+    connect(hashesTask.data(), &FileHashesTask::progressChanged, this, [this](int percent) {
+        if (hashesProgressLabel) {
+            hashesProgressLabel->setText(tr("Computing hashes... %1%").arg(percent));
+        }
+    });
+    QWeakPointer<FileHashesTask> weakTask = hashesTask;
+    connect(hashesTask.data(), &AsyncTask::finished, this, [this, weakTask]() {
+        auto task = weakTask.toStrongRef();
+        if (!task || task != hashesTask) {
+            return;
+        }
+        hashesTask.clear();
+        if (!task->isSuccessful()) {
+            if (hashesProgressLabel) {
+                hashesProgressLabel->setText(tr("Failed to compute hashes"));
+            }
+            return;
+        }
+        hashesCache.insert(task->getIdentity(), task->getHashes());
+        resetHashesWidget();
+        showHashes(task->getHashes());
+    });
+    Core()->getAsyncTaskManager()->start(hashesTask);
+}
+
+QFormLayout *Dashboard::resetHashesWidget()
+{
+    // Delete hashesWidget if it isn't null to avoid duplicate components
+    if (hashesWidget) {
+        hashesWidget->deleteLater();
+    }
+
+    // Define dynamic components to hold the hashes
+    hashesWidget = new QWidget();
+    QFormLayout *hashesLayout = new QFormLayout;
+    hashesWidget->setLayout(hashesLayout);
+    ui->hashesVerticalLayout->addWidget(hashesWidget);
+    return hashesLayout;
+}
+
+void Dashboard::showHashes(const QList<FileHash> &hashes)
+{
+    auto hashesLayout = static_cast<QFormLayout *>(hashesWidget->layout());
+
+    // Add hashes as a pair of Hash Name : Hash Value.
+    for (const auto &hash : hashes) {
+        // Create a bold QString with the hash name uppercased
+        QString label = QString("<b>%1:</b>").arg(hash.type.toUpper());
+
+        // Define a Read-Only line edit to display the hash value
+        QLineEdit *hashLineEdit = new QLineEdit();
+        hashLineEdit->setReadOnly(true);
+        hashLineEdit->setText(hash.hex);
+
+        // Set cursor position to begining to avoid long hashes (e.g sha256)
+        // to look truncated at the begining
+        hashLineEdit->setCursorPosition(0);
+
+        // Add both controls to a form layout in a single row
+        hashesLayout->addRow(new QLabel(label), hashLineEdit);
+    }
+}
+
+void Dashboard::cancelHashes()
+{
+    if (hashesTask) {
+        hashesTask->interrupt();
+        hashesTask.clear();
+    }
+}
+
 void Dashboard::on_certificateButton_clicked()
 {
     QDialog dialog(this);
@@ -2,11 +2,14 @@
 #define DASHBOARD_H
 
 #include <QFormLayout>
+#include <QPointer>
 #include <memory>
 #include "core/Cutter.h"
+#include "common/FileHashesTask.h"
 #include "CutterDockWidget.h"
 
 QT_BEGIN_NAMESPACE
+QT_FORWARD_DECLARE_CLASS(QLabel)
 QT_FORWARD_DECLARE_CLASS(QLineEdit)
 QT_FORWARD_DECLARE_CLASS(QJsonObject)
 QT_END_NAMESPACE
@@ -23,7 +26,7 @@ class Dashboard : public CutterDockWidget
 
 public:
     explicit Dashboard(MainWindow *main);
-    ~Dashboard();
+    ~Dashboard() override;
 
 private slots:
     void updateContents();
@@ -36,7 +39,23 @@ private:
     void setRzBinInfo(const RzBinInfo *binInfo);
     const char *setBoolText(bool value);
 
+    /**
+     * @brief Show the hashes of the file with the given RzIO fd, starting to compute them in the
+     * background if they are not cached yet.
+     */
+    void updateHashes(int fd, const QString &identity);
+    QFormLayout *resetHashesWidget();
+    void showHashes(const QList<FileHash> &hashes);
+    void cancelHashes();
+
     QWidget *hashesWidget = nullptr;
+    QPointer<QLabel> hashesProgressLabel;
+    QSharedPointer<FileHashesTask> hashesTask;
+    /**
+     * Hashes by file identity (uri, size and modification time), so that refreshing doesn't
+     * compute them again.
+     */
+    QHash<QString, QList<FileHash>> hashesCache;
 };
 
 #endif // DASHBOARD_H
@@ -7,6 +7,7 @@
 #include "common/TempConfig.h"
 #include "common/SelectionHighlight.h"
 #include "common/Decompiler.h"
+#include "common/DecompilerPrefetcher.h"
 #include "common/CutterSeekable.h"
 #include "core/MainWindow.h"
 #include "common/DecompilerHighlighter.h"
@@ -24,7 +25,6 @@ DecompilerWidget::DecompilerWidget(MainWindow *main)
     : MemoryDockWidget(MemoryWidgetType::Decompiler, main),
       mCtxMenu(new DecompilerContextMenu(this, main)),
       ui(new Ui::DecompilerWidget),
-      decompilerBusy(false),
       seekFromCursor(false),
       historyPos(0),
       previousFunctionAddr(RVA_INVALID),
@@ -92,7 +92,11 @@ DecompilerWidget::DecompilerWidget(MainWindow *main)
     connect(Core(), &CutterCore::flagsChanged, this, &DecompilerWidget::doRefresh);
     connect(Core(), &CutterCore::globalVarsChanged, this, &DecompilerWidget::doRefresh);
     connect(Core(), &CutterCore::commentsChanged, this, &DecompilerWidget::refreshIfChanged);
-    connect(Core(), &CutterCore::instructionChanged, this, &DecompilerWidget::refreshIfChanged);
+    connect(Core(), &CutterCore::instructionChanged, this, [this](RVA addr, RVA size) {
+        if (addressInRange(addr, size)) {
+            doRefresh();
+        }
+    });
     connect(Core(), &CutterCore::refreshCodeViews, this, &DecompilerWidget::doRefresh);
 
     // Esc to seek backward
@@ -103,7 +107,10 @@ DecompilerWidget::DecompilerWidget(MainWindow *main)
     connect(seekPrevAction, &QAction::triggered, seekable, &CutterSeekable::seekPrev);
 }
 
-DecompilerWidget::~DecompilerWidget() = default;
+DecompilerWidget::~DecompilerWidget()
+{
+    abandonDecompileRequest();
+}
 
 QString DecompilerWidget::getWidgetType()
 {
@@ -264,13 +271,8 @@ void DecompilerWidget::doRefresh()
     // decompilation.
     ui->progressLabel->setVisible(true);
     ui->decompilerComboBox->setEnabled(false);
-    if (dec->isRunning()) {
-        if (!decompilerBusy) {
-            connect(dec, &Decompiler::finished, this, &DecompilerWidget::doRefresh);
-        }
-        return;
-    }
-    disconnect(dec, &Decompiler::finished, this, &DecompilerWidget::doRefresh);
+    // The latest seek wins, the result of a running request is not needed anymore
+    abandonDecompileRequest();
     // Clear all selections since we just refreshed
     ui->textEdit->setExtraSelections({});
     previousFunctionAddr = decompiledFunctionAddr;
@@ -287,9 +289,29 @@ void DecompilerWidget::doRefresh()
         return;
     }
     mCtxMenu->setDecompiledFunctionAddress(decompiledFunctionAddr);
-    connect(dec, &Decompiler::finished, this, &DecompilerWidget::decompilationFinished);
-    decompilerBusy = true;
-    dec->decompileAt(addr);
+    decompilingGeneration = Core()->getAnalysisGeneration();
+    if (RzAnnotatedCode *cached = Core()->getDecompilationCache()->find(
+                dec->getId(), decompiledFunctionAddr, decompilingGeneration)) {
+        // Decompiled before and nothing changed since then
+        showDecompiledCode(cached);
+        return;
+    }
+    Core()->getDecompilerPrefetcher()->cancel();
+    connect(dec, &Decompiler::requestFinished, this, &DecompilerWidget::decompilationFinished,
+            Qt::UniqueConnection);
+    requestDecompiler = dec;
+    decompileRequest = dec->requestDecompilation(addr);
+}
+
+void DecompilerWidget::abandonDecompileRequest()
+{
+    waitingForDecompiler = false;
+    quint64 request = decompileRequest;
+    // Cleared first, canceling reports the request as finished
+    decompileRequest = 0;
+    if (request && requestDecompiler) {
+        requestDecompiler->cancelRequest(request);
+    }
 }
 
 void DecompilerWidget::refreshDecompiler()
@@ -309,7 +331,33 @@ QTextCursor DecompilerWidget::getCursorForAddress(RVA addr)
     return cursor;
 }
 
-void DecompilerWidget::decompilationFinished(RzAnnotatedCode *codeDecompiled)
+void DecompilerWidget::decompilationFinished(quint64 requestId, RzAnnotatedCode *codeDecompiled)
+{
+    auto dec = qobject_cast<Decompiler *>(sender());
+    if (!decompileRequest || requestId != decompileRequest) {
+        // Result of another widget or the prefetcher
+        if (waitingForDecompiler && dec && !dec->hasRequests()) {
+            waitingForDecompiler = false;
+            doRefresh();
+        }
+        return;
+    }
+    decompileRequest = 0;
+    if (!codeDecompiled) {
+        // Superseded by the request of another widget
+        waitingForDecompiler = true;
+        return;
+    }
+
+    if (dec && !RZ_STR_ISEMPTY(codeDecompiled->code)) {
+        Core()->getDecompilationCache()->insert(dec->getId(), decompiledFunctionAddr,
+                                                decompilingGeneration, *codeDecompiled);
+    }
+    // The code is owned by the decompiler
+    showDecompiledCode(DecompilationCache::copyCode(*codeDecompiled));
+}
+
+void DecompilerWidget::showDecompiledCode(RzAnnotatedCode *codeDecompiled)
 {
     ui->progressLabel->setVisible(false);
     ui->decompilerComboBox->setEnabled(decompilerSelectionEnabled);
@@ -317,10 +365,6 @@ void DecompilerWidget::decompilationFinished(RzAnnotatedCode *codeDecompiled)
     mCtxMenu->setAnnotationHere(nullptr);
     setCode(codeDecompiled);
 
-    Decompiler *dec = getCurrentDecompiler();
-    QObject::disconnect(dec, &Decompiler::finished, this, &DecompilerWidget::decompilationFinished);
-    decompilerBusy = false;
-
     if (ui->textEdit->toPlainText().isEmpty()) {
         setCode(Decompiler::makeWarning(tr("Cannot decompile at this address (Not a function?)")));
         lowestOffsetInCode = RVA_MAX;
@@ -351,6 +395,10 @@ void DecompilerWidget::decompilationFinished(RzAnnotatedCode *codeDecompiled)
         ui->textEdit->horizontalScrollBar()->setSliderPosition(scrollHistory[historyPos].first);
         ui->textEdit->verticalScrollBar()->setSliderPosition(scrollHistory[historyPos].second);
     }
+
+    if (Decompiler *dec = getCurrentDecompiler()) {
+        Core()->getDecompilerPrefetcher()->schedule(dec, decompiledFunctionAddr);
+    }
 }
 
 void DecompilerWidget::setAnnotationsAtCursor(size_t pos)
@@ -598,9 +646,10 @@ void DecompilerWidget::copy()
     }
 }
 
-bool DecompilerWidget::addressInRange(RVA addr)
+bool DecompilerWidget::addressInRange(RVA addr, RVA size)
 {
-    if (lowestOffsetInCode <= addr && addr <= highestOffsetInCode) {
+    RVA last = size > RVA_MAX - addr ? RVA_MAX : addr + (size ? size - 1 : 0);
+    if (lowestOffsetInCode <= last && addr <= highestOffsetInCode) {
         return true;
     }
     return false;
@@ -2,6 +2,7 @@
 #define DECOMPILERWIDGET_H
 
 #include <QTextEdit>
+#include <QPointer>
 #include <memory>
 
 #include "core/Cutter.h"
@@ -54,7 +55,7 @@ private slots:
      *     - Auto-refresh is disabled.
      */
     void seekChanged(RVA /* addr */, CutterCore::SeekHistoryType type);
-    void decompilationFinished(RzAnnotatedCode *code);
+    void decompilationFinished(quint64 requestId, RzAnnotatedCode *code);
 
 private:
     std::unique_ptr<Ui::DecompilerWidget> ui;
@@ -66,10 +67,18 @@ private:
     bool decompilerSelectionEnabled;
 
     /**
-     * True if the selected decompiler is currently running a decompilation for this widget. Once
-     * the decompilation is over, this should be set to false.
+     * Id of the decompilation request running for this widget, 0 if there is none. Results of
+     * older requests are ignored.
      */
-    bool decompilerBusy;
+    quint64 decompileRequest = 0;
+    QPointer<Decompiler> requestDecompiler;
+    /**
+     * True if the request of this widget was superseded by one of another widget, the refresh is
+     * repeated once the decompiler is idle.
+     */
+    bool waitingForDecompiler = false;
+    /// Analysis generation at the start of the current decompilation, for caching the result
+    quint64 decompilingGeneration = 0;
 
     bool seekFromCursor;
     int historyPos;
@@ -244,14 +253,24 @@ private:
      */
     void setAnnotationsAtCursor(size_t pos);
     /**
-     * @brief Checks if the specified address is a part of the decompiled function.
+     * @brief Checks if the specified range overlaps the decompiled function.
      *
      * @param addr An offset in the binary.
+     * @param size Number of bytes starting at addr.
      * @return True if the specified is a part of the decompiled function, False otherwise.
      */
-    bool addressInRange(RVA addr);
+    bool addressInRange(RVA addr, RVA size = 1);
 
     void setCode(RzAnnotatedCode *code);
+    /**
+     * @brief Show decompiled code of decompiledFunctionAddr, either fresh from the decompiler or
+     * from the cache. Takes ownership of \a code.
+     */
+    void showDecompiledCode(RzAnnotatedCode *code);
+    /**
+     * @brief Cancel the request running for this widget, if any
+     */
+    void abandonDecompileRequest();
 
     void setHighlighter(bool annotationBasedHighlighter);
 };
@@ -20,13 +20,13 @@
 #include <QPropertyAnimation>
 #include <QShortcut>
 #include <QToolTip>
-#include <QTextDocument>
 #include <QTextEdit>
 #include <QVBoxLayout>
 #include <QRegularExpression>
 #include <QClipboard>
 #include <QApplication>
 #include <QAction>
+#include <QFontMetricsF>
 
 #include <cmath>
 
@@ -168,10 +168,20 @@ DisassemblerGraphView::~DisassemblerGraphView()
 }
 
 void DisassemblerGraphView::refreshView()
+{
+    // Everything triggering a refresh may change the disassembly text or the placement
+    clearGraphCache();
+    graphFcnAddr = RVA_INVALID;
+    reloadGraph();
+}
+
+void DisassemblerGraphView::reloadGraph()
 {
     CutterGraphView::refreshView();
+    showSimplifiedBlockTitle = Config()->getGraphSimplifiedBlockTitle();
+    simplifiedTitleScale = 0;
     loadCurrentGraph();
-    breakpoints = Core()->getBreakpointsAddresses();
+    breakpoints = Core()->getBreakpointsAddressSet();
     emit viewRefreshed();
 }
 
@@ -183,8 +193,11 @@ void DisassemblerGraphView::loadCurrentGraph()
             .set("asm.lines", false)
             .set("asm.lines.fcn", false);
 
+    storeCurrentGraph();
     disassembly_blocks.clear();
     blocks.clear();
+    graphFcnAddr = RVA_INVALID;
+    graphPlaced = false;
 
     if (highlight_token) {
         delete highlight_token;
@@ -222,8 +235,13 @@ void DisassemblerGraphView::loadCurrentGraph()
     setEntry(fcn ? fcn->addr : RVA_INVALID);
 
     if (!fcn) {
+        cancelGraphPlacement();
+        return;
+    }
+    if (restoreCachedGraph(fcn->addr)) {
         return;
     }
+    graphFcnAddr = fcn->addr;
 
     for (const auto &bbi : CutterPVector<RzAnalysisBlock>(fcn->bbs)) {
         RVA bbiFail = bbi->fail;
@@ -297,12 +315,12 @@ void DisassemblerGraphView::loadCurrentGraph()
                 instr.size = (bbi->addr + bbi->size) - instr.addr;
             }
 
-            QTextDocument textDoc;
-            textDoc.setHtml(CutterCore::ansiEscapeToHtml(op->text));
-
-            instr.plainText = textDoc.toPlainText();
+            QVector<DisassemblyTextRun> runs = Core()->disassemblyTextRuns(op->offset, op->text);
+            for (const DisassemblyTextRun &run : runs) {
+                instr.plainText += run.text;
+            }
 
-            RichTextPainter::List richText = RichTextPainter::fromTextDocument(textDoc);
+            RichTextPainter::List richText = RichTextPainter::fromTextRuns(runs);
             // Colors::colorizeAssembly(richText, textDoc.toPlainText(), 0);
 
             bool cropped;
@@ -320,7 +338,82 @@ void DisassemblerGraphView::loadCurrentGraph()
         addBlock(gb);
     }
     cleanupEdges(blocks);
-    computeGraphPlacement();
+    computeGraphPlacementAsync();
+    graphPlaced = !isGraphPlacementPending();
+}
+
+void DisassemblerGraphView::graphPlacementComputed()
+{
+    graphPlaced = true;
+    // The view was moved using the old block positions, show the current block again
+    RVA addr = seekable->getOffset();
+    if (DisassemblyBlock *db = blockForAddress(addr)) {
+        transition_dont_seek = true;
+        showBlock(blocks[db->entry]);
+        showInstruction(blocks[db->entry], addr);
+    }
+    emit viewRefreshed();
+}
+
+void DisassemblerGraphView::storeCurrentGraph()
+{
+    // An unfinished placement would have to be started again anyway
+    if (graphFcnAddr == RVA_INVALID || !graphPlaced) {
+        return;
+    }
+    RVA fcnAddr = graphFcnAddr;
+    graphFcnAddr = RVA_INVALID;
+
+    auto oldIt = graphCache.find(fcnAddr);
+    if (oldIt != graphCache.end()) {
+        graphCacheLru.erase(oldIt->lruPos);
+        graphCache.erase(oldIt);
+    }
+    CachedGraph &cached = graphCache[fcnAddr];
+    cached.disassemblyBlocks = std::move(disassembly_blocks);
+    cached.blocks = std::move(blocks);
+    cached.width = width;
+    cached.height = height;
+    graphCacheLru.push_front(fcnAddr);
+    cached.lruPos = graphCacheLru.begin();
+
+    while (graphCache.size() > MAX_CACHED_GRAPHS) {
+        graphCache.remove(graphCacheLru.back());
+        graphCacheLru.pop_back();
+    }
+}
+
+bool DisassemblerGraphView::restoreCachedGraph(RVA fcnAddr)
+{
+    auto it = graphCache.find(fcnAddr);
+    if (it == graphCache.end()) {
+        return false;
+    }
+    graphCacheLru.erase(it->lruPos);
+    disassembly_blocks = std::move(it->disassemblyBlocks);
+    GraphLayout::Graph cachedBlocks = std::move(it->blocks);
+    int cachedWidth = it->width;
+    int cachedHeight = it->height;
+    graphCache.erase(it);
+
+    setPlacedBlocks(std::move(cachedBlocks), cachedWidth, cachedHeight);
+    graphFcnAddr = fcnAddr;
+    graphPlaced = true;
+    return true;
+}
+
+void DisassemblerGraphView::clearGraphCache()
+{
+    graphCache.clear();
+    graphCacheLru.clear();
+}
+
+void DisassemblerGraphView::updateLayout()
+{
+    // Cached graphs were placed by the previous layout
+    clearGraphCache();
+    CutterGraphView::updateLayout();
+    graphPlaced = true;
 }
 
 DisassemblerGraphView::EdgeConfigurationMapping DisassemblerGraphView::getEdgeConfigurations()
@@ -456,7 +549,8 @@ void DisassemblerGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block,
                     highlightWidth = block.width - widthBefore - (10 + 2 * padding);
                 }
 
-                QColor selectionColor = ConfigColor("wordHighlight");
+                static const ColorKey wordHighlightKey("wordHighlight");
+                QColor selectionColor = ConfigColor(wordHighlightKey);
 
                 p.fillRect(
                         QRectF(block.x + textOffset + widthBefore, y, highlightWidth, charHeight),
@@ -483,8 +577,9 @@ void DisassemblerGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block,
                                       int(instr.text.lines.size()) * charHeight);
 
         QColor instrColor;
-        if (Core()->isBreakpoint(breakpoints, instr.addr)) {
-            instrColor = ConfigColor("gui.breakpoint_background");
+        if (breakpoints.contains(instr.addr)) {
+            static const ColorKey breakpointBackgroundKey("gui.breakpoint_background");
+            instrColor = ConfigColor(breakpointBackgroundKey);
         } else if (instr.addr == PCAddr) {
             instrColor = PCSelectionColor;
         } else if (auto background = bih->getBasicInstruction(instr.addr)) {
@@ -508,6 +603,50 @@ void DisassemblerGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block,
     }
 }
 
+void DisassemblerGraphView::drawSimplifiedBlock(QPainter &p, GraphView::GraphBlock &block)
+{
+    QRectF blockRect(block.x, block.y, block.width, block.height);
+    DisassemblyBlock &db = disassembly_blocks[block.entry];
+
+    // Only look at the block boundaries, the cost must not depend on the number of instructions
+    RVA addr = seekable->getOffset();
+    bool blockSelected = !db.instrs.empty() && addr >= db.instrs.front().addr
+            && (addr < db.instrs.back().addr || db.instrs.back().contains(addr));
+
+    QColor background = blockSelected ? disassemblySelectedBackgroundColor
+                                      : disassemblyBackgroundColor;
+    if (auto bb = Core()->getBBHighlighter()->getBasicBlock(block.entry)) {
+        background = bb->color;
+    }
+    p.setPen(QPen(graphNodeColor, 0));
+    p.setBrush(background);
+    p.drawRect(blockRect);
+
+    if (!showSimplifiedBlockTitle) {
+        return;
+    }
+    qreal scale = p.combinedTransform().m22();
+    if (!qFuzzyCompare(scale, simplifiedTitleScale)) {
+        // Keep the title at the regular font size on screen
+        simplifiedTitleFont = Config()->getFont();
+        simplifiedTitleFont.setPointSizeF(simplifiedTitleFont.pointSizeF() / scale);
+        simplifiedTitleScale = scale;
+    }
+    if (blockRect.height() * scale < charHeight) {
+        return;
+    }
+    QFontMetricsF titleMetrics(simplifiedTitleFont);
+    QString title = titleMetrics.elidedText(RzAddressString(block.entry), Qt::ElideRight,
+                                            blockRect.width());
+    if (title.isEmpty()) {
+        return;
+    }
+    static const ColorKey offsetKey("offset");
+    p.setPen(ConfigColor(offsetKey));
+    p.setFont(simplifiedTitleFont);
+    p.drawText(blockRect, Qt::AlignCenter, title);
+}
+
 GraphView::EdgeConfiguration DisassemblerGraphView::edgeConfiguration(GraphView::GraphBlock &from,
                                                                       GraphView::GraphBlock *to,
                                                                       bool interactive)
@@ -715,8 +854,8 @@ void DisassemblerGraphView::onSeekChanged(RVA addr)
     DisassemblyBlock *db = blockForAddress(addr);
     bool switchFunction = false;
     if (!db) {
-        // not in this function, try refreshing
-        refreshView();
+        // not in this function, load the graph of the new one
+        reloadGraph();
         db = blockForAddress(addr);
         switchFunction = true;
     }
@@ -1006,11 +1145,48 @@ void DisassemblerGraphView::restoreCurrentBlock()
 
 void DisassemblerGraphView::paintEvent(QPaintEvent *event)
 {
-    // DisassemblerGraphView is always dirty
-    setCacheDirty();
+    // Redraw only the parts of the graph affected by state changes since the last paint
+    RVA offset = seekable->getOffset();
+    RVA pcAddr = Core()->getProgramCounterValue();
+    QString highlight = highlight_token ? highlight_token->content : QString();
+    if (highlight != paintedHighlight) {
+        setCacheDirty();
+    } else {
+        if (offset != paintedOffset) {
+            invalidateBlockAt(paintedOffset);
+            invalidateBlockAt(offset);
+        }
+        if (pcAddr != paintedPCAddr) {
+            invalidateBlockAt(paintedPCAddr);
+            invalidateBlockAt(pcAddr);
+        }
+        if (currentBlockAddress != paintedCurrentBlock) {
+            invalidateBlockAt(paintedCurrentBlock);
+            invalidateBlockAt(currentBlockAddress);
+        }
+    }
+    paintedOffset = offset;
+    paintedPCAddr = pcAddr;
+    paintedCurrentBlock = currentBlockAddress;
+    paintedHighlight = highlight;
     GraphView::paintEvent(event);
 }
 
+void DisassemblerGraphView::invalidateBlockAt(RVA addr)
+{
+    if (addr == RVA_INVALID) {
+        return;
+    }
+    DisassemblyBlock *db = blockForAddress(addr);
+    if (!db) {
+        return;
+    }
+    auto blockIt = blocks.find(db->entry);
+    if (blockIt != blocks.end()) {
+        invalidateBlock(blockIt->second);
+    }
+}
+
 bool DisassemblerGraphView::Instr::contains(ut64 addr) const
 {
     return this->addr <= addr && (addr - this->addr) < size;
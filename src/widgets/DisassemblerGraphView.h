@@ -8,6 +8,8 @@
 #include <QShortcut>
 #include <QLabel>
 
+#include <list>
+
 #include "widgets/CutterGraphView.h"
 #include "menus/DisassemblyContextMenu.h"
 #include "common/RichTextPainter.h"
@@ -94,6 +96,7 @@ public:
     ~DisassemblerGraphView() override;
     std::unordered_map<ut64, DisassemblyBlock> disassembly_blocks;
     virtual void drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive) override;
+    void drawSimplifiedBlock(QPainter &p, GraphView::GraphBlock &block) override;
     virtual void blockClicked(GraphView::GraphBlock &block, QMouseEvent *event,
                               QPoint pos) override;
     virtual void blockDoubleClicked(GraphView::GraphBlock &block, QMouseEvent *event,
@@ -139,6 +142,8 @@ protected:
                                    QPoint pos) override;
     void contextMenuEvent(QContextMenuEvent *event) override;
     void restoreCurrentBlock() override;
+    void graphPlacementComputed() override;
+    void updateLayout() override;
     bool eventFilter(QObject *obj, QEvent *event) override;
 
 private slots:
@@ -177,17 +182,67 @@ private:
     const Instr *instrForAddress(RVA addr);
     DisassemblyBlock *blockForAddress(RVA addr);
     void seekLocal(RVA addr, bool update_viewport = true);
+    void invalidateBlockAt(RVA addr);
     void seekInstruction(bool previous_instr);
+    /**
+     * @brief Load the graph of the function at the current offset, keeping cached graphs.
+     */
+    void reloadGraph();
+    /**
+     * @brief Move the shown graph into graphCache if it is completely prepared and placed.
+     */
+    void storeCurrentGraph();
+    /**
+     * @brief Show the cached graph of a function, removing it from graphCache.
+     * @return false if the function is not cached
+     */
+    bool restoreCachedGraph(RVA fcnAddr);
+    void clearGraphCache();
 
     CutterSeekable *seekable = nullptr;
     QList<QShortcut *> shortcuts;
-    QList<RVA> breakpoints;
+    QSet<RVA> breakpoints;
 
     QAction actionUnhighlight;
     QAction actionUnhighlightInstruction;
 
     QLabel *emptyText = nullptr;
 
+    /// State the cached graph rendering was painted with
+    RVA paintedOffset = RVA_INVALID;
+    RVA paintedPCAddr = RVA_INVALID;
+    RVA paintedCurrentBlock = RVA_INVALID;
+    QString paintedHighlight;
+
+    bool showSimplifiedBlockTitle = true;
+    /// Font for the titles of simplified blocks, scaled to stay readable at simplifiedTitleScale
+    QFont simplifiedTitleFont;
+    qreal simplifiedTitleScale = 0;
+
+    /**
+     * @brief Prepared blocks and placement of a function graph which is not shown.
+     */
+    struct CachedGraph
+    {
+        std::unordered_map<ut64, DisassemblyBlock> disassemblyBlocks;
+        GraphLayout::Graph blocks;
+        int width = 0;
+        int height = 0;
+        std::list<RVA>::iterator lruPos;
+    };
+    static constexpr int MAX_CACHED_GRAPHS = 16;
+
+    /**
+     * @brief Graphs of recently shown functions, so navigating back to them skips the
+     * disassembly and the layout. Cleared by everything which refreshes the view.
+     */
+    QHash<RVA, CachedGraph> graphCache;
+    std::list<RVA> graphCacheLru; ///< Most recently used first
+    /// Function whose blocks are loaded, RVA_INVALID if there is none
+    RVA graphFcnAddr = RVA_INVALID;
+    /// Whether the layout of the loaded blocks is done, only placed graphs are cached
+    bool graphPlaced = false;
+
 signals:
     void nameChanged(const QString &name);
 
@@ -19,6 +19,7 @@
 #include <QPainter>
 #include <QPainterPath>
 #include <QSplitter>
+#include <QTimer>
 
 #include <algorithm>
 #include <cmath>
@@ -247,6 +248,9 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
         return;
     }
 
+    bufferedLines.clear();
+    bufferedTop = 0;
+
     if (maxLines <= 0) {
         connectCursorPositionChanged(true);
         mDisasTextEdit->clear();
@@ -254,7 +258,7 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
         return;
     }
 
-    breakpoints = Core()->getBreakpointsAddresses();
+    breakpoints = Core()->getBreakpointsAddressSet();
     int horizontalScrollValue = mDisasTextEdit->horizontalScrollBar()->value();
     mDisasTextEdit->setLockScroll(true); // avoid flicker
 
@@ -262,7 +266,7 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
     {
         TempConfig tempConfig;
         tempConfig.set("scr.color", COLOR_MODE_16M).set("asm.lines", false);
-        lines = Core()->disassembleLines(topOffset, maxLines);
+        lines = Core()->disassembleLineRuns(topOffset, maxLines);
     }
 
     connectCursorPositionChanged(true);
@@ -274,16 +278,11 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
         if (line.offset < topOffset) { // overflow
             break;
         }
-        cursor.insertHtml(line.text);
-        if (Core()->isBreakpoint(breakpoints, line.offset)) {
-            QTextBlockFormat f;
-            f.setBackground(ConfigColor("gui.breakpoint_background"));
-            cursor.setBlockFormat(f);
-        }
-        auto a = new DisassemblyTextBlockUserData(line);
-        cursor.block().setUserData(a);
+        insertLine(cursor, line);
+        setBlockLine(cursor.block(), line);
         cursor.insertBlock();
         cursor.setBlockFormat(regular);
+        bufferedLines << line;
     }
 
     if (!lines.isEmpty()) {
@@ -312,6 +311,239 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
 
     // Refresh the left panel (trigger paintEvent)
     leftPanel->update();
+
+    prefetchBufferedLines();
+}
+
+void DisassemblyWidget::insertLine(QTextCursor &cursor, const DisassemblyLine &line)
+{
+    for (const DisassemblyTextRun &run : line.runs) {
+        QTextCharFormat format;
+        if (run.color.isValid()) {
+            format.setForeground(run.color);
+        }
+        if (run.background.isValid()) {
+            format.setBackground(run.background);
+        }
+        cursor.insertText(run.text, format);
+    }
+}
+
+void DisassemblyWidget::setBlockLine(QTextBlock block, const DisassemblyLine &line)
+{
+    static const ColorKey breakpointBackgroundKey("gui.breakpoint_background");
+    QTextBlockFormat format;
+    if (breakpoints.contains(line.offset)) {
+        format.setBackground(ConfigColor(breakpointBackgroundKey));
+    }
+    QTextCursor(block).setBlockFormat(format);
+    block.setUserData(new DisassemblyTextBlockUserData(line));
+}
+
+bool DisassemblyWidget::appendBufferedLines(int count)
+{
+    // Disassemble again from the last instruction, its lines may have been cut off
+    RVA last = bufferedLines.last().offset;
+    int keep = bufferedLines.size();
+    while (keep > 0 && bufferedLines[keep - 1].offset == last) {
+        keep--;
+    }
+    if (keep <= bufferedTop) {
+        return false;
+    }
+    QList<DisassemblyLine> more;
+    {
+        TempConfig tempConfig;
+        tempConfig.set("scr.color", COLOR_MODE_16M).set("asm.lines", false);
+        more = Core()->disassembleLineRuns(last, count + bufferedLines.size() - keep);
+    }
+    if (more.isEmpty() || more.first().offset != last) {
+        return false;
+    }
+    bufferedLines.erase(bufferedLines.begin() + keep, bufferedLines.end());
+    for (const DisassemblyLine &line : more) {
+        if (line.offset < last) { // overflow
+            break;
+        }
+        bufferedLines << line;
+    }
+    return true;
+}
+
+bool DisassemblyWidget::prependBufferedLines(int count)
+{
+    RVA first = bufferedLines.first().offset;
+    RVA start = Core()->prevOpAddr(first, count);
+    if (start >= first) {
+        return false;
+    }
+    // Instructions can have many lines for flags, comments and variables
+    QList<DisassemblyLine> more;
+    {
+        TempConfig tempConfig;
+        tempConfig.set("scr.color", COLOR_MODE_16M).set("asm.lines", false);
+        more = Core()->disassembleLineRuns(start, count * 2 + 64);
+    }
+    int end = 0;
+    while (end < more.size() && more[end].offset < first && more[end].offset >= start) {
+        end++;
+    }
+    // The disassembly must end exactly where the buffered lines start
+    if (end == 0 || end >= more.size() || more[end].offset != first) {
+        return false;
+    }
+    more.erase(more.begin() + end, more.end());
+    bufferedLines = more + bufferedLines;
+    bufferedTop += end;
+    return true;
+}
+
+void DisassemblyWidget::prefetchBufferedLines()
+{
+    if (bufferPrefetchScheduled) {
+        return;
+    }
+    bufferPrefetchScheduled = true;
+    // Run after the visible lines have been painted
+    QTimer::singleShot(0, this, [this]() {
+        bufferPrefetchScheduled = false;
+        if (bufferedLines.isEmpty() || maxLines <= 0) {
+            return;
+        }
+        const int pages = BUFFERED_PAGES;
+        int wanted = pages * maxLines;
+        if (bufferedTop < maxLines) {
+            prependBufferedLines(wanted);
+        }
+        if (bufferedLines.size() - bufferedTop - maxLines < maxLines) {
+            appendBufferedLines(wanted + maxLines);
+        }
+
+        // Drop lines too far away from the visible ones, keeping whole instructions at the top
+        int limit = (pages + 1) * maxLines;
+        if (bufferedTop > limit) {
+            int drop = bufferedTop - limit;
+            while (drop < bufferedTop
+                   && bufferedLines[drop].offset == bufferedLines[drop - 1].offset) {
+                drop++;
+            }
+            bufferedLines.erase(bufferedLines.begin(), bufferedLines.begin() + drop);
+            bufferedTop -= drop;
+        }
+        if (bufferedLines.size() > bufferedTop + maxLines + limit) {
+            bufferedLines.erase(bufferedLines.begin() + bufferedTop + maxLines + limit,
+                                bufferedLines.end());
+        }
+    });
+}
+
+bool DisassemblyWidget::scrollBuffered(int count)
+{
+    if (bufferedLines.isEmpty() || maxLines <= 0 || bufferedTop >= bufferedLines.size()) {
+        return false;
+    }
+    int oldTop = bufferedTop;
+    int oldCount = std::min(maxLines, int(bufferedLines.size()) - oldTop);
+
+    int newTop = bufferedTop;
+    if (count > 0) {
+        for (int i = 0; i < count; i++) {
+            RVA offset = bufferedLines[newTop].offset;
+            while (newTop < bufferedLines.size() && bufferedLines[newTop].offset == offset) {
+                newTop++;
+            }
+            if (newTop + maxLines >= bufferedLines.size()) {
+                if (!appendBufferedLines(maxLines)) {
+                    return false;
+                }
+            }
+            if (newTop >= bufferedLines.size()) {
+                return false;
+            }
+        }
+    } else {
+        for (int i = 0; i < -count; i++) {
+            if (newTop == 0) {
+                int before = bufferedTop;
+                if (!prependBufferedLines(std::max(-count - i, maxLines))) {
+                    return false;
+                }
+                int added = bufferedTop - before;
+                newTop += added;
+                oldTop += added;
+            }
+            RVA offset = bufferedLines[newTop - 1].offset;
+            while (newTop > 0 && bufferedLines[newTop - 1].offset == offset) {
+                newTop--;
+            }
+        }
+    }
+    int newCount = std::min(maxLines, int(bufferedLines.size()) - newTop);
+    if (newTop + newCount <= oldTop || newTop >= oldTop + oldCount) {
+        // Nothing of the old lines stays visible
+        return false;
+    }
+
+    if (mDisasTextEdit->document()->blockCount() != oldCount) {
+        // The view is not completely filled, it's not worth handling this
+        return false;
+    }
+
+    breakpoints = Core()->getBreakpointsAddressSet();
+    int horizontalScrollValue = mDisasTextEdit->horizontalScrollBar()->value();
+    mDisasTextEdit->setLockScroll(true);
+    connectCursorPositionChanged(true);
+
+    QTextDocument *document = mDisasTextEdit->document();
+    QTextCursor cursor(document);
+    if (newTop > oldTop) {
+        cursor.setPosition(document->findBlockByNumber(newTop - oldTop).position(),
+                           QTextCursor::KeepAnchor);
+        cursor.removeSelectedText();
+    } else if (newTop < oldTop) {
+        for (int i = newTop; i < oldTop; i++) {
+            insertLine(cursor, bufferedLines[i]);
+            cursor.insertBlock();
+        }
+    }
+
+    int oldEnd = oldTop + oldCount;
+    int newEnd = newTop + newCount;
+    if (oldEnd > newEnd) {
+        cursor.setPosition(document->findBlockByNumber(newCount - 1).position());
+        cursor.movePosition(QTextCursor::EndOfBlock);
+        cursor.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
+        cursor.removeSelectedText();
+    } else if (oldEnd < newEnd) {
+        cursor.movePosition(QTextCursor::End);
+        for (int i = oldEnd; i < newEnd; i++) {
+            cursor.insertBlock();
+            insertLine(cursor, bufferedLines[i]);
+        }
+    }
+
+    // Splitting and merging blocks doesn't keep their formats and data reliably, so set them
+    // again for the new blocks and the old ones next to them.
+    for (int i = newTop; i <= std::max(newTop, oldTop); i++) {
+        setBlockLine(document->findBlockByNumber(i - newTop), bufferedLines[i]);
+    }
+    for (int i = std::min(oldEnd, newEnd) - 1; i < newEnd; i++) {
+        setBlockLine(document->findBlockByNumber(i - newTop), bufferedLines[i]);
+    }
+
+    bufferedTop = newTop;
+    lines = bufferedLines.mid(newTop, newCount);
+    topOffset = lines.first().offset;
+    bottomOffset = lines.last().offset;
+
+    connectCursorPositionChanged(false);
+    updateCursorPosition();
+    mDisasTextEdit->setLockScroll(false);
+    mDisasTextEdit->horizontalScrollBar()->setValue(horizontalScrollValue);
+    leftPanel->update();
+
+    prefetchBufferedLines();
+    return true;
 }
 
 void DisassemblyWidget::scrollInstructions(int count)
@@ -320,6 +552,11 @@ void DisassemblyWidget::scrollInstructions(int count)
         return;
     }
 
+    if (scrollBuffered(count)) {
+        topOffsetHistory[topOffsetHistoryPos] = topOffset;
+        return;
+    }
+
     RVA offset;
     if (count > 0) {
         offset = Core()->nextOpAddr(topOffset, count);
@@ -574,7 +811,7 @@ void DisassemblyWidget::moveCursorRelative(bool up, bool page)
                 // disassembly from calculated offset may have more than maxLines lines
                 // move some instructions down if necessary.
 
-                auto lines = Core()->disassembleLines(offset, maxLines).toVector();
+                auto lines = Core()->disassembleLineRuns(offset, maxLines).toVector();
                 int oldTopLine;
                 for (oldTopLine = lines.length(); oldTopLine > 0; oldTopLine--) {
                     if (lines[oldTopLine - 1].offset < topOffset) {
@@ -832,13 +1069,16 @@ void DisassemblyLeftPanel::paintEvent(QPaintEvent *event)
     auto tEdit = qobject_cast<DisassemblyTextEdit *>(disas->getTextWidget());
     int topOffset = int(tEdit->contentsMargins().top() + tEdit->textOffset());
     int lineHeight = disas->getFontMetrics().height();
-    QColor arrowColorDown = ConfigColor("flow");
-    QColor arrowColorUp = ConfigColor("cflow");
+    static const ColorKey flowKey("flow");
+    static const ColorKey cflowKey("cflow");
+    static const ColorKey backgroundKey("gui.background");
+    QColor arrowColorDown = ConfigColor(flowKey);
+    QColor arrowColorUp = ConfigColor(cflowKey);
     QPainter p(this);
     QPen penDown(arrowColorDown, penSizePix, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin);
     QPen penUp(arrowColorUp, penSizePix, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin);
     // Fill background
-    p.fillRect(event->rect(), Config()->getColor("gui.background").darker(115));
+    p.fillRect(event->rect(), ConfigColor(backgroundKey).darker(115));
 
     QList<DisassemblyLine> lines = disas->getLines();
     if (lines.size() == 0) {
@@ -858,17 +1098,11 @@ void DisassemblyLeftPanel::paintEvent(QPaintEvent *event)
         minViewOffset = std::min(minViewOffset, lines[i].offset);
         maxViewOffset = std::max(maxViewOffset, lines[i].offset);
         if (lines[i].arrow != RVA_INVALID) {
-            Arrow a { lines[i].offset, lines[i].arrow };
-            bool contains = std::find_if(std::begin(arrows), std::end(arrows),
-                                         [&](const Arrow &it) {
-                                             return it.min == a.min && it.max == a.max;
-                                         })
-                    != std::end(arrows);
-            if (!contains) {
-                arrows.emplace_back(lines[i].offset, lines[i].arrow);
-            }
+            addArrow(lines[i].offset, lines[i].arrow);
         }
     }
+    // Start over once the levels got too deep, but only when the arrows change anyway
+    assignLevels(maxLevel > maxLevelBeforeFlush, maxViewOffset - minViewOffset);
 
     auto addOffsetOutsideScreen = [&](RVA offset) {
         if (offset < minViewOffset || offset > maxViewOffset) {
@@ -917,44 +1151,6 @@ void DisassemblyLeftPanel::paintEvent(QPaintEvent *event)
         return res->second;
     };
 
-    auto fitsInScreen = [&](const Arrow &a) { return maxViewOffset - minViewOffset < a.length(); };
-
-    std::sort(std::begin(arrows), std::end(arrows), [&](const Arrow &l, const Arrow &r) {
-        int lScreen = fitsInScreen(l), rScreen = fitsInScreen(r);
-        if (lScreen != rScreen) {
-            return lScreen < rScreen;
-        }
-        return l.max != r.max ? l.max < r.max : l.min > r.min;
-    });
-
-    int minLine = 0, maxLine = 0;
-    for (auto &it : arrows) {
-        minLine = std::min(offsetToLine(it.min), minLine);
-        maxLine = std::max(offsetToLine(it.max), maxLine);
-        it.level = 0;
-    }
-
-    const int MAX_ARROW_LINES = 1 << 18;
-    uint32_t maxLevel = 0;
-    if (!arrows.empty() && maxLine - minLine < MAX_ARROW_LINES) {
-        // Limit maximum tree range to MAX_ARROW_LINES as sanity check, since the tree is designed
-        // for dense ranges. Under normal conditions due to amount lines fitting screen and number
-        // of arrows remembered should be few hundreds at most.
-        MinMaxAccumulateTree<uint32_t> maxLevelTree(maxLine - minLine + 2);
-        for (Arrow &arrow : arrows) {
-            int top = offsetToLine(arrow.min) - minLine;
-            int bottom = offsetToLine(arrow.max) - minLine + 1;
-            auto minMax = maxLevelTree.rangeMinMax(top, bottom);
-            if (minMax.first > 1) {
-                arrow.level = 1; // place bellow existing lines
-            } else {
-                arrow.level = minMax.second + 1; // place on top of existing lines
-                maxLevel = std::max(maxLevel, arrow.level);
-            }
-            maxLevelTree.updateRange(top, bottom, arrow.level);
-        }
-    }
-
     const RVA currOffset = disas->getSeekable()->getOffset();
     const qreal pixelRatio = qhelpers::devicePixelRatio(p.device());
     const Arrow visibleRange { lines.first().offset, lines.last().offset };
@@ -1000,10 +1196,6 @@ void DisassemblyLeftPanel::paintEvent(QPaintEvent *event)
         }
     }
 
-    if (maxLevel > maxLevelBeforeFlush) {
-        arrows.clear();
-    }
-
     const size_t eraseN = arrows.size() > arrowsSize ? arrows.size() - arrowsSize : 0;
     if (eraseN > 0) {
         const bool scrolledDown = lastBeginOffset > lines.first().offset;
@@ -1014,17 +1206,103 @@ void DisassemblyLeftPanel::paintEvent(QPaintEvent *event)
                 return l.jmpFromOffset() > r.jmpFromOffset();
             }
         });
-        arrows.erase(std::end(arrows) - eraseN, std::end(arrows));
+        removeArrows(std::end(arrows) - eraseN, std::end(arrows));
     }
 
     lastBeginOffset = lines.first().offset;
 }
 
+void DisassemblyLeftPanel::addArrow(RVA from, RVA to)
+{
+    Arrow arrow(from, to);
+    if (arrowRanges.insert({ arrow.min, arrow.max }).second) {
+        arrows.push_back(arrow);
+    }
+}
+
+void DisassemblyLeftPanel::removeArrows(std::vector<Arrow>::iterator first,
+                                        std::vector<Arrow>::iterator last)
+{
+    for (auto it = first; it != last; ++it) {
+        arrowRanges.erase({ it->min, it->max });
+    }
+    arrows.erase(first, last);
+    // The remaining arrows keep their levels
+    maxLevel = 0;
+    for (const Arrow &arrow : arrows) {
+        maxLevel = std::max(maxLevel, arrow.level);
+    }
+}
+
+void DisassemblyLeftPanel::assignLevels(bool reassign, RVA viewLength)
+{
+    std::vector<Arrow *> unassigned;
+    for (Arrow &arrow : arrows) {
+        if (arrow.level == 0) {
+            unassigned.push_back(&arrow);
+        }
+    }
+    if (unassigned.empty()) {
+        return;
+    }
+    if (reassign) {
+        unassigned.clear();
+        maxLevel = 0;
+        for (Arrow &arrow : arrows) {
+            arrow.level = 0;
+            unassigned.push_back(&arrow);
+        }
+    }
+
+    // Levels only depend on the order of the offsets, so the tree is indexed by the position of
+    // the offsets among all arrow ends.
+    std::vector<RVA> ends;
+    ends.reserve(arrows.size() * 2);
+    for (const Arrow &arrow : arrows) {
+        ends.push_back(arrow.min);
+        ends.push_back(arrow.max);
+    }
+    std::sort(ends.begin(), ends.end());
+    ends.erase(std::unique(ends.begin(), ends.end()), ends.end());
+    auto endIndex = [&](RVA offset) -> size_t {
+        return std::lower_bound(ends.begin(), ends.end(), offset) - ends.begin();
+    };
+
+    MinMaxAccumulateTree<uint32_t> maxLevelTree(ends.size() + 1);
+    for (const Arrow &arrow : arrows) {
+        if (arrow.level != 0) {
+            maxLevelTree.updateRange(endIndex(arrow.min), endIndex(arrow.max) + 1, arrow.level);
+        }
+    }
+
+    auto fitsInScreen = [&](const Arrow *a) { return viewLength < a->length(); };
+    std::sort(unassigned.begin(), unassigned.end(), [&](const Arrow *l, const Arrow *r) {
+        int lScreen = fitsInScreen(l), rScreen = fitsInScreen(r);
+        if (lScreen != rScreen) {
+            return lScreen < rScreen;
+        }
+        return l->max != r->max ? l->max < r->max : l->min > r->min;
+    });
+
+    for (Arrow *arrow : unassigned) {
+        size_t top = endIndex(arrow->min);
+        size_t bottom = endIndex(arrow->max) + 1;
+        auto minMax = maxLevelTree.rangeMinMax(top, bottom);
+        if (minMax.first > 1) {
+            arrow->level = 1; // place bellow existing lines
+        } else {
+            arrow->level = minMax.second + 1; // place on top of existing lines
+        }
+        maxLevel = std::max(maxLevel, arrow->level);
+        maxLevelTree.updateRange(top, bottom, arrow->level);
+    }
+}
+
 void DisassemblyLeftPanel::clearArrowFrom(RVA offset)
 {
     auto it = std::find_if(arrows.begin(), arrows.end(),
                            [&](const Arrow &it) { return it.jmpFromOffset() == offset; });
     if (it != arrows.end()) {
-        arrows.erase(it);
+        removeArrows(it, std::next(it));
     }
 }
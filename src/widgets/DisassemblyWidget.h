@@ -12,6 +12,8 @@
 #include <QShortcut>
 #include <QAction>
 
+#include <set>
+#include <utility>
 #include <vector>
 
 class DisassemblyTextEdit;
@@ -83,6 +85,18 @@ private:
 
     RefreshDeferrer *disasmRefresh;
 
+    /**
+     * Lines around the visible ones, so scrolling only needs to disassemble and insert the lines
+     * which become visible. Starts with a complete instruction, the lines of the last instruction
+     * may be cut off. Reset by every refresh.
+     */
+    QList<DisassemblyLine> bufferedLines;
+    /// Index of the first line shown in mDisasTextEdit
+    int bufferedTop = 0;
+    bool bufferPrefetchScheduled = false;
+    /// Pages of lines kept in bufferedLines above and below the visible ones
+    static constexpr int BUFFERED_PAGES = 2;
+
     RVA readCurrentDisassemblyOffset();
     bool eventFilter(QObject *obj, QEvent *event) override;
     void keyPressEvent(QKeyEvent *event) override;
@@ -91,7 +105,7 @@ private:
     int topOffsetHistoryPos = 0;
     QList<RVA> topOffsetHistory;
 
-    QList<RVA> breakpoints;
+    QSet<RVA> breakpoints;
 
     void setupFonts();
     void setupColors();
@@ -102,6 +116,17 @@ private:
 
     void moveCursorRelative(bool up, bool page);
 
+    void insertLine(QTextCursor &cursor, const DisassemblyLine &line);
+    void setBlockLine(QTextBlock block, const DisassemblyLine &line);
+    /**
+     * @brief Scroll using bufferedLines, only changing the lines at the edges of the document.
+     * @return false if the lines are not available, a full refresh is needed then
+     */
+    bool scrollBuffered(int count);
+    bool appendBufferedLines(int count);
+    bool prependBufferedLines(int count);
+    void prefetchBufferedLines();
+
     void jumpToOffsetUnderCursor(const QTextCursor &);
 };
 
@@ -187,14 +212,28 @@ private:
 
         RVA min;
         RVA max;
-        uint32_t level;
+        uint32_t level; ///< 0 until a level has been assigned
         bool up;
     };
 
+    void addArrow(RVA from, RVA to);
+    void removeArrows(std::vector<Arrow>::iterator first, std::vector<Arrow>::iterator last);
+    /**
+     * @brief Assign levels to the arrows which don't have one yet, placing them around the
+     * existing ones. With \a reassign all arrows get new levels.
+     * @param viewLength distance between the first and the last visible offset, arrows longer
+     * than it are placed outside of the shorter ones
+     */
+    void assignLevels(bool reassign, RVA viewLength);
+
     const size_t arrowsSize = 128;
     const uint32_t maxLevelBeforeFlush = 32;
     RVA lastBeginOffset = 0;
+    /// Arrows seen recently, kept across paints so their levels stay the same while scrolling
     std::vector<Arrow> arrows;
+    /// min and max of all arrows, for finding out whether a jump is known already
+    std::set<std::pair<RVA, RVA>> arrowRanges;
+    uint32_t maxLevel = 0;
 };
 
 #endif // DISASSEMBLYWIDGET_H
@@ -86,51 +86,62 @@ QString ExportsModel::name(const QModelIndex &index) const
     return exp.name;
 }
 
+const ExportDescription *ExportsModel::description(QModelIndex index) const
+{
+    if (index.row() < exports->size()) {
+        return &exports->at(index.row());
+    }
+    return nullptr;
+}
+
 ExportsProxyModel::ExportsProxyModel(ExportsModel *source_model, QObject *parent)
     : AddressableFilterProxyModel(source_model, parent)
 {
+    setCommentColumn(ExportsModel::CommentColumn);
     setFilterCaseSensitivity(Qt::CaseInsensitive);
     setSortCaseSensitivity(Qt::CaseInsensitive);
 }
 
 bool ExportsProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
 {
-    QModelIndex index = sourceModel()->index(row, 0, parent);
-    auto exp = index.data(ExportsModel::ExportDescriptionRole).value<ExportDescription>();
+    auto source = static_cast<ExportsModel *>(sourceModel());
+    QModelIndex index = source->index(row, 0, parent);
+    const ExportDescription *exp = source->description(index);
 
-    return qhelpers::filterStringContains(exp.name, this);
+    return qhelpers::filterStringContains(exp->name, this);
 }
 
 bool ExportsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
-    auto leftExp = left.data(ExportsModel::ExportDescriptionRole).value<ExportDescription>();
-    auto rightExp = right.data(ExportsModel::ExportDescriptionRole).value<ExportDescription>();
+    auto source = static_cast<ExportsModel *>(sourceModel());
+    const ExportDescription *leftExp = source->description(left);
+    const ExportDescription *rightExp = source->description(right);
 
     switch (left.column()) {
     case ExportsModel::SizeColumn:
-        if (leftExp.size != rightExp.size)
-            return leftExp.size < rightExp.size;
+        if (leftExp->size != rightExp->size)
+            return leftExp->size < rightExp->size;
     // fallthrough
     case ExportsModel::OffsetColumn:
-        if (leftExp.vaddr != rightExp.vaddr)
-            return leftExp.vaddr < rightExp.vaddr;
+        if (leftExp->vaddr != rightExp->vaddr)
+            return leftExp->vaddr < rightExp->vaddr;
     // fallthrough
     case ExportsModel::NameColumn:
-        if (leftExp.name != rightExp.name)
-            return leftExp.name < rightExp.name;
+        if (leftExp->name != rightExp->name)
+            return leftExp->name < rightExp->name;
     // fallthrough
     case ExportsModel::TypeColumn:
-        if (leftExp.type != rightExp.type)
-            return leftExp.type < rightExp.type;
+        if (leftExp->type != rightExp->type)
+            return leftExp->type < rightExp->type;
     // fallthrough
     case ExportsModel::CommentColumn:
-        return Core()->getCommentAt(leftExp.vaddr) < Core()->getCommentAt(rightExp.vaddr);
+        return AddressableFilterProxyModel::lessThan(left, right);
     default:
         break;
     }
 
     // fallback
-    return leftExp.vaddr < rightExp.vaddr;
+    return leftExp->vaddr < rightExp->vaddr;
 }
 
 ExportsWidget::ExportsWidget(MainWindow *main) : ListDockWidget(main)
@@ -49,6 +49,8 @@ public:
 
     RVA address(const QModelIndex &index) const override;
     QString name(const QModelIndex &index) const override;
+
+    const ExportDescription *description(QModelIndex index) const;
 };
 
 class ExportsProxyModel : public AddressableFilterProxyModel
@@ -98,16 +98,31 @@ const FlagDescription *FlagsModel::description(QModelIndex index) const
     return nullptr;
 }
 
+void FlagsModel::applyDelta(const FlagsDelta &delta)
+{
+    applyListDelta(*flags, flagRows, delta, &FlagDescription::name);
+}
+
 FlagsSortFilterProxyModel::FlagsSortFilterProxyModel(FlagsModel *source_model, QObject *parent)
     : AddressableFilterProxyModel(source_model, parent)
 {
+    setCommentColumn(FlagsModel::COMMENT);
+    setFilterIndexEnabled(true);
 }
 
 bool FlagsSortFilterProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
 {
-    QModelIndex index = sourceModel()->index(row, 0, parent);
-    FlagDescription flag = index.data(FlagsModel::FlagDescriptionRole).value<FlagDescription>();
-    return qhelpers::filterStringContains(flag.name, this);
+    if (parent.isValid()) {
+        return false;
+    }
+    return filterKeyContains(row);
+}
+
+QString FlagsSortFilterProxyModel::filterKey(int sourceRow) const
+{
+    auto source = static_cast<FlagsModel *>(sourceModel());
+    const FlagDescription *flag = source->description(source->index(sourceRow, 0));
+    return flag ? flag->name : QString();
 }
 
 bool FlagsSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
@@ -132,7 +147,7 @@ bool FlagsSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIn
         return left_flag->realname < right_flag->realname;
 
     case FlagsModel::COMMENT:
-        return Core()->getCommentAt(left_flag->offset) < Core()->getCommentAt(right_flag->offset);
+        return AddressableFilterProxyModel::lessThan(left, right);
 
     default:
         break;
@@ -265,9 +280,16 @@ void FlagsWidget::refreshFlags()
     if (flagspace_data.isValid())
         flagspace = flagspace_data.value<FlagspaceDescription>().name;
 
-    flags_model->beginResetModel();
-    flags = Core()->getAllFlags(flagspace);
-    flags_model->endResetModel();
+    if (flagspace != flagsSpace) {
+        flagsSpace = flagspace;
+        flagsGeneration = 0;
+    }
+    FlagsDelta delta = Core()->getFlagsDelta(flagsGeneration, flagspace);
+    flagsGeneration = delta.generation;
+    if (delta.isEmpty()) {
+        return;
+    }
+    flags_model->applyDelta(delta);
 
     tree->showItemsNumber(flags_proxy_model->rowCount());
 
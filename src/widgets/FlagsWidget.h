@@ -23,6 +23,8 @@ class FlagsModel : public AddressableItemModel<QAbstractListModel>
 
 private:
     QList<FlagDescription> *flags;
+    /// Row of each flag in flags
+    QHash<QString, int> flagRows;
 
 public:
     enum Columns { OFFSET = 0, SIZE, NAME, REALNAME, COMMENT, COUNT };
@@ -41,6 +43,11 @@ public:
     QString name(const QModelIndex &index) const override;
 
     const FlagDescription *description(QModelIndex index) const;
+
+    /**
+     * @brief Update the flags with the changes from CutterCore::getFlagsDelta()
+     */
+    void applyDelta(const FlagsDelta &delta);
 };
 
 class FlagsSortFilterProxyModel : public AddressableFilterProxyModel
@@ -53,6 +60,7 @@ public:
 protected:
     bool filterAcceptsRow(int row, const QModelIndex &parent) const override;
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+    QString filterKey(int sourceRow) const override;
 };
 
 namespace Ui {
@@ -84,6 +92,9 @@ private:
     FlagsModel *flags_model;
     FlagsSortFilterProxyModel *flags_proxy_model;
     QList<FlagDescription> flags;
+    /// Flagspace and generation of flags, see CutterCore::getFlagsDelta()
+    QString flagsSpace;
+    quint64 flagsGeneration = 0;
     CutterTreeWidget *tree;
 
     void refreshFlags();
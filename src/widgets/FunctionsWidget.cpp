@@ -120,11 +120,11 @@ QVariant FunctionModel::data(const QModelIndex &index, int role) const
         subnode = false;
     }
 
-    const FunctionDescription &function = functions->at(function_index);
-
     if (function_index >= functions->count())
         return QVariant();
 
+    const FunctionDescription &function = functions->at(function_index);
+
     switch (role) {
     case Qt::DisplayRole:
         if (nested) {
@@ -346,14 +346,23 @@ void FunctionModel::setNested(bool nested)
 
 RVA FunctionModel::address(const QModelIndex &index) const
 {
-    auto function = data(index, FunctionDescriptionRole).value<FunctionDescription>();
-    return function.offset;
+    const FunctionDescription *function = index.isValid() ? description(index) : nullptr;
+    return function ? function->offset : RVA_INVALID;
 }
 
 QString FunctionModel::name(const QModelIndex &index) const
 {
-    auto function = data(index, FunctionDescriptionRole).value<FunctionDescription>();
-    return function.name;
+    const FunctionDescription *function = index.isValid() ? description(index) : nullptr;
+    return function ? function->name : QString();
+}
+
+const FunctionDescription *FunctionModel::description(QModelIndex index) const
+{
+    int row = index.internalId() != 0 ? index.parent().row() : index.row();
+    if (row >= 0 && row < functions->size()) {
+        return &functions->at(row);
+    }
+    return nullptr;
 }
 
 void FunctionModel::seekChanged(RVA)
@@ -392,32 +401,115 @@ bool FunctionModel::updateCurrentIndex()
     return changed;
 }
 
-void FunctionModel::functionRenamed(const RVA offset, const QString &new_name)
+void FunctionModel::applyDelta(const FunctionsDelta &delta)
 {
-    for (int i = 0; i < functions->count(); i++) {
-        FunctionDescription &function = (*functions)[i];
-        if (function.offset == offset) {
-            function.name = new_name;
-            emit dataChanged(index(i, 0), index(i, columnCount() - 1));
+    RVA currentOffset = currentIndex >= 0 && currentIndex < functions->count()
+            ? functions->at(currentIndex).offset
+            : RVA_INVALID;
+    if (nested && !delta.reset && !delta.removed.isEmpty()) {
+        // Child indices refer to the row of their parent, which moves when rows above it are
+        // removed, so the whole model is reset instead
+        QList<FunctionDescription> updated = *functions;
+        QHash<RVA, int> rows = functionRows;
+        for (const FunctionDescription &function : delta.updated) {
+            auto it = rows.constFind(function.offset);
+            if (it != rows.constEnd()) {
+                updated[it.value()] = function;
+            } else {
+                rows.insert(function.offset, updated.size());
+                updated.append(function);
+            }
+        }
+        QSet<RVA> removed;
+        for (RVA offset : delta.removed) {
+            removed.insert(offset);
+        }
+        FunctionsDelta reset;
+        reset.generation = delta.generation;
+        reset.reset = true;
+        for (const FunctionDescription &function : updated) {
+            if (!removed.contains(function.offset)) {
+                reset.updated.append(function);
+            }
+        }
+        applyListDelta(*functions, functionRows, reset, &FunctionDescription::offset);
+    } else {
+        applyListDelta(*functions, functionRows, delta, &FunctionDescription::offset);
+        if (nested && !delta.reset) {
+            // The children show the details of their function
+            for (const FunctionDescription &function : delta.updated) {
+                int row = functionRows.value(function.offset, -1);
+                if (row < 0) {
+                    continue;
+                }
+                QModelIndex parent = index(row, 0);
+                emit dataChanged(index(0, 0, parent), index(rowCount(parent) - 1, 0, parent));
+            }
+        }
+    }
+    // Rows may have moved or been removed
+    currentIndex = functionRows.value(currentOffset, -1);
+    seekChanged(Core()->getOffset());
+}
+
+void FunctionModel::setImportsAndMain(const QSet<RVA> &imports, ut64 main)
+{
+    QSet<RVA> changed = *importAddresses;
+    changed.subtract(imports);
+    QSet<RVA> added = imports;
+    added.subtract(*importAddresses);
+    changed.unite(added);
+    if (*mainAdress != main) {
+        changed.insert(*mainAdress);
+        changed.insert(main);
+    }
+    *importAddresses = imports;
+    *mainAdress = main;
+
+    for (RVA offset : changed) {
+        int row = functionRows.value(offset, -1);
+        if (row < 0 || row >= functions->count()) {
+            continue;
+        }
+        emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+        if (nested) {
+            QModelIndex parent = index(row, 0);
+            emit dataChanged(index(0, 0, parent), index(rowCount(parent) - 1, 0, parent));
         }
     }
 }
 
+void FunctionModel::functionRenamed(const RVA offset, const QString &new_name)
+{
+    auto it = functionRows.constFind(offset);
+    if (it == functionRows.constEnd() || it.value() >= functions->count()) {
+        return;
+    }
+    int row = it.value();
+    (*functions)[row].name = new_name;
+    emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+}
+
 FunctionSortFilterProxyModel::FunctionSortFilterProxyModel(FunctionModel *source_model,
                                                            QObject *parent)
     : AddressableFilterProxyModel(source_model, parent)
 {
+    setCommentColumn(FunctionModel::CommentColumn);
     setFilterCaseSensitivity(Qt::CaseInsensitive);
     setSortCaseSensitivity(Qt::CaseInsensitive);
+    setFilterIndexEnabled(true);
 }
 
 bool FunctionSortFilterProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
 {
-    QModelIndex index = sourceModel()->index(row, 0, parent);
-    FunctionDescription function =
-            index.data(FunctionModel::FunctionDescriptionRole).value<FunctionDescription>();
+    // Nested rows show details of the function of their parent
+    return filterKeyContains(parent.isValid() ? parent.row() : row);
+}
 
-    return qhelpers::filterStringContains(function.name, this);
+QString FunctionSortFilterProxyModel::filterKey(int sourceRow) const
+{
+    auto source = static_cast<FunctionModel *>(sourceModel());
+    return source->name(source->index(sourceRow, 0));
 }
 
 bool FunctionSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
@@ -428,60 +520,60 @@ bool FunctionSortFilterProxyModel::lessThan(const QModelIndex &left, const QMode
     if (left.parent().isValid() || right.parent().isValid())
         return false;
 
-    FunctionDescription left_function =
-            left.data(FunctionModel::FunctionDescriptionRole).value<FunctionDescription>();
-    FunctionDescription right_function =
-            right.data(FunctionModel::FunctionDescriptionRole).value<FunctionDescription>();
+    auto source = static_cast<FunctionModel *>(sourceModel());
+    const FunctionDescription *left_function = source->description(left);
+    const FunctionDescription *right_function = source->description(right);
+    if (!left_function || !right_function)
+        return false;
 
-    if (static_cast<FunctionModel *>(sourceModel())->isNested()) {
-        return left_function.name < right_function.name;
+    if (source->isNested()) {
+        return left_function->name < right_function->name;
     } else {
         switch (left.column()) {
         case FunctionModel::OffsetColumn:
-            return left_function.offset < right_function.offset;
+            return left_function->offset < right_function->offset;
         case FunctionModel::SizeColumn:
-            if (left_function.linearSize != right_function.linearSize)
-                return left_function.linearSize < right_function.linearSize;
+            if (left_function->linearSize != right_function->linearSize)
+                return left_function->linearSize < right_function->linearSize;
             break;
         case FunctionModel::ImportColumn: {
-            bool left_is_import = left.data(FunctionModel::IsImportRole).toBool();
-            bool right_is_import = right.data(FunctionModel::IsImportRole).toBool();
+            bool left_is_import = source->isImport(*left_function);
+            bool right_is_import = source->isImport(*right_function);
             if (!left_is_import && right_is_import)
                 return true;
             break;
         }
         case FunctionModel::NameColumn:
-            return left_function.name < right_function.name;
+            return left_function->name < right_function->name;
         case FunctionModel::NargsColumn:
-            if (left_function.nargs != right_function.nargs)
-                return left_function.nargs < right_function.nargs;
+            if (left_function->nargs != right_function->nargs)
+                return left_function->nargs < right_function->nargs;
             break;
         case FunctionModel::NlocalsColumn:
-            if (left_function.nlocals != right_function.nlocals)
-                return left_function.nlocals < right_function.nlocals;
+            if (left_function->nlocals != right_function->nlocals)
+                return left_function->nlocals < right_function->nlocals;
             break;
         case FunctionModel::NbbsColumn:
-            if (left_function.nbbs != right_function.nbbs)
-                return left_function.nbbs < right_function.nbbs;
+            if (left_function->nbbs != right_function->nbbs)
+                return left_function->nbbs < right_function->nbbs;
             break;
         case FunctionModel::CalltypeColumn:
-            return left_function.calltype < right_function.calltype;
+            return left_function->calltype < right_function->calltype;
         case FunctionModel::EdgesColumn:
-            if (left_function.edges != right_function.edges)
-                return left_function.edges < right_function.edges;
+            if (left_function->edges != right_function->edges)
+                return left_function->edges < right_function->edges;
             break;
         case FunctionModel::FrameColumn:
-            if (left_function.stackframe != right_function.stackframe)
-                return left_function.stackframe < right_function.stackframe;
+            if (left_function->stackframe != right_function->stackframe)
+                return left_function->stackframe < right_function->stackframe;
             break;
         case FunctionModel::CommentColumn:
-            return Core()->getCommentAt(left_function.offset)
-                    < Core()->getCommentAt(right_function.offset);
+            return AddressableFilterProxyModel::lessThan(left, right);
         default:
             return false;
         }
 
-        return left_function.offset < right_function.offset;
+        return left_function->offset < right_function->offset;
     }
 }
 
@@ -560,19 +652,20 @@ void FunctionsWidget::refreshTree()
         task->wait();
     }
 
-    task = QSharedPointer<FunctionsTask>(new FunctionsTask());
+    task = QSharedPointer<FunctionsTask>(new FunctionsTask(functionsGeneration));
     connect(task.data(), &FunctionsTask::fetchFinished, this,
-            [this](const QList<FunctionDescription> &functions) {
-                functionModel->beginResetModel();
-
-                this->functions = functions;
+            [this](const FunctionsDelta &delta) {
+                functionsGeneration = delta.generation;
+                if (delta.isEmpty()) {
+                    return;
+                }
 
-                importAddresses.clear();
+                QSet<RVA> imports;
                 for (const ImportDescription &import : Core()->getAllImports()) {
-                    importAddresses.insert(import.plt);
+                    imports.insert(import.plt);
                 }
 
-                mainAdress = RVA_INVALID;
+                ut64 mainAddress = RVA_INVALID;
                 RzCoreLocked core(Core());
                 RzBinFile *bf = rz_bin_cur(core->bin);
                 if (bf) {
@@ -580,16 +673,20 @@ void FunctionsWidget::refreshTree()
                             rz_bin_object_get_special_symbol(bf->o, RZ_BIN_SPECIAL_SYMBOL_MAIN);
                     if (binmain) {
                         int va = core->io->va || core->bin->is_debugger;
-                        mainAdress = va ? rz_bin_object_addr_with_base(bf->o, binmain->vaddr)
-                                        : binmain->paddr;
+                        mainAddress = va
+                                ? rz_bin_object_addr_with_base(bf->o, binmain->vaddr)
+                                : binmain->paddr;
                     }
                 }
 
-                functionModel->updateCurrentIndex();
-                functionModel->endResetModel();
+                // Before the delta, so rows of unchanged functions get repainted too
+                functionModel->setImportsAndMain(imports, mainAddress);
+                functionModel->applyDelta(delta);
 
-                // resize offset and size columns
-                qhelpers::adjustColumns(ui->treeView, 3, 0);
+                if (delta.reset) {
+                    // resize offset and size columns
+                    qhelpers::adjustColumns(ui->treeView, 3, 0);
+                }
             });
     Core()->getAsyncTaskManager()->start(task);
 }
@@ -19,6 +19,8 @@ class FunctionModel : public AddressableItemModel<>
 
 private:
     QList<FunctionDescription> *functions;
+    /// Row of each function in functions
+    QHash<RVA, int> functionRows;
     QSet<RVA> *importAddresses;
     ut64 *mainAdress;
 
@@ -81,8 +83,26 @@ public:
     void setNested(bool nested);
     bool isNested() { return nested; }
 
+    /**
+     * @brief Update the functions with the changes from CutterCore::getFunctionsDelta()
+     */
+    void applyDelta(const FunctionsDelta &delta);
+    /**
+     * @brief Replace the addresses of imports and main, updating the rows styled by them
+     */
+    void setImportsAndMain(const QSet<RVA> &imports, ut64 main);
+
     RVA address(const QModelIndex &index) const override;
     QString name(const QModelIndex &index) const override;
+
+    /**
+     * @return the function of \a index, of its parent for nested rows
+     */
+    const FunctionDescription *description(QModelIndex index) const;
+    bool isImport(const FunctionDescription &function) const
+    {
+        return functionIsImport(function.offset);
+    }
 private slots:
     void seekChanged(RVA addr);
     void functionRenamed(const RVA offset, const QString &new_name);
@@ -98,6 +118,7 @@ public:
 protected:
     bool filterAcceptsRow(int row, const QModelIndex &parent) const override;
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+    QString filterKey(int sourceRow) const override;
 };
 
 class FunctionsWidget : public ListDockWidget
@@ -121,6 +142,8 @@ private slots:
 private:
     QSharedPointer<FunctionsTask> task;
     QList<FunctionDescription> functions;
+    /// Generation of functions, see CutterCore::getFunctionsDelta()
+    quint64 functionsGeneration = 0;
     QSet<RVA> importAddresses;
     ut64 mainAdress;
     FunctionModel *functionModel;
@@ -84,35 +84,46 @@ QString GlobalsModel::name(const QModelIndex &index) const
     return global.name;
 }
 
+const GlobalDescription *GlobalsModel::description(QModelIndex index) const
+{
+    if (index.row() < globals->size()) {
+        return &globals->at(index.row());
+    }
+    return nullptr;
+}
+
 GlobalsProxyModel::GlobalsProxyModel(GlobalsModel *sourceModel, QObject *parent)
     : AddressableFilterProxyModel(sourceModel, parent)
 {
+    setCommentColumn(GlobalsModel::CommentColumn);
     setFilterCaseSensitivity(Qt::CaseInsensitive);
     setSortCaseSensitivity(Qt::CaseInsensitive);
 }
 
 bool GlobalsProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
 {
-    QModelIndex index = sourceModel()->index(row, 0, parent);
-    auto global = index.data(GlobalsModel::GlobalDescriptionRole).value<GlobalDescription>();
+    auto source = static_cast<GlobalsModel *>(sourceModel());
+    QModelIndex index = source->index(row, 0, parent);
+    const GlobalDescription *global = source->description(index);
 
-    return qhelpers::filterStringContains(global.name, this);
+    return qhelpers::filterStringContains(global->name, this);
 }
 
 bool GlobalsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
-    auto leftGlobal = left.data(GlobalsModel::GlobalDescriptionRole).value<GlobalDescription>();
-    auto rightGlobal = right.data(GlobalsModel::GlobalDescriptionRole).value<GlobalDescription>();
+    auto source = static_cast<GlobalsModel *>(sourceModel());
+    const GlobalDescription *leftGlobal = source->description(left);
+    const GlobalDescription *rightGlobal = source->description(right);
 
     switch (left.column()) {
     case GlobalsModel::AddressColumn:
-        return leftGlobal.addr < rightGlobal.addr;
+        return leftGlobal->addr < rightGlobal->addr;
     case GlobalsModel::TypeColumn:
-        return leftGlobal.type < rightGlobal.type;
+        return leftGlobal->type < rightGlobal->type;
     case GlobalsModel::NameColumn:
-        return leftGlobal.name < rightGlobal.name;
+        return leftGlobal->name < rightGlobal->name;
     case GlobalsModel::CommentColumn:
-        return Core()->getCommentAt(leftGlobal.addr) < Core()->getCommentAt(rightGlobal.addr);
+        return AddressableFilterProxyModel::lessThan(left, right);
     default:
         break;
     }
@@ -44,6 +44,8 @@ public:
 
     RVA address(const QModelIndex &index) const override;
     QString name(const QModelIndex &index) const override;
+
+    const GlobalDescription *description(QModelIndex index) const;
 };
 
 class GlobalsProxyModel : public AddressableFilterProxyModel
@@ -284,6 +284,7 @@ void GraphGridLayout::CalculateLayout(GraphLayout::Graph &blocks, ut64 entry, in
 {
     LayoutState layoutState;
     layoutState.blocks = &blocks;
+    layoutState.interruptions = getInterruptions();
     if (blocks.empty()) {
         return;
     }
@@ -299,6 +300,9 @@ void GraphGridLayout::CalculateLayout(GraphLayout::Graph &blocks, ut64 entry, in
 
     auto blockOrder = topoSort(layoutState, entry);
     computeAllBlockPlacement(blockOrder, layoutState);
+    if (isInterrupted(layoutState.interruptions)) {
+        return;
+    }
 
     for (auto &blockIt : blocks) {
         layoutState.edge[blockIt.first].resize(blockIt.second.edges.size());
@@ -338,9 +342,12 @@ void GraphGridLayout::CalculateLayout(GraphLayout::Graph &blocks, ut64 entry, in
     }
 
     routeEdges(layoutState);
+    if (isInterrupted(layoutState.interruptions)) {
+        return;
+    }
 
     convertToPixelCoordinates(layoutState, width, height);
-    if (useLayoutOptimization) {
+    if (useLayoutOptimization && !isInterrupted(layoutState.interruptions)) {
         optimizeLayout(layoutState);
         cropToContent(blocks, width, height);
     }
@@ -1687,6 +1694,9 @@ void GraphGridLayout::optimizeLayout(GraphGridLayout::LayoutState &state) const
     optimizeLinearProgram(solution.size(), objectiveFunction, inequalities, equalities, solution);
     copyVariablesToPositions(solution, true);
     connectEdgeEnds(*state.blocks);
+    if (isInterrupted(state.interruptions)) {
+        return;
+    }
 
     // vertical segments
     variableGroups.resize(blockMapping.size());
@@ -98,6 +98,9 @@ private:
         std::vector<int> rowOffset;
         std::vector<int> edgeColumnOffset;
         std::vector<int> edgeRowOffset;
+
+        /// Value of getInterruptions when the calculation started
+        unsigned interruptions = 0;
     };
 
     using GridBlockMap = std::unordered_map<ut64, GridBlock>;
@@ -54,3 +54,8 @@ void GraphHorizontalAdapter::swapLayoutConfigDirection()
     std::swap(layoutConfig.edgeVerticalSpacing, layoutConfig.edgeHorizontalSpacing);
     std::swap(layoutConfig.blockVerticalSpacing, layoutConfig.blockHorizontalSpacing);
 }
+
+void GraphHorizontalAdapter::interrupt()
+{
+    layout->interrupt();
+}
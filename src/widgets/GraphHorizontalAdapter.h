@@ -16,6 +16,7 @@ public:
     virtual void CalculateLayout(GraphLayout::Graph &blocks, ut64 entry, int &width,
                                  int &height) const override;
     void setLayoutConfig(const LayoutConfig &config) override;
+    void interrupt() override;
 
 private:
     std::unique_ptr<GraphLayout> layout;
@@ -3,6 +3,7 @@
 
 #include "core/Cutter.h"
 
+#include <atomic>
 #include <unordered_map>
 
 class GraphLayout
@@ -43,9 +44,28 @@ public:
     virtual ~GraphLayout() {}
     virtual void CalculateLayout(Graph &blocks, ut64 entry, int &width, int &height) const = 0;
     virtual void setLayoutConfig(const LayoutConfig &config) { this->layoutConfig = config; };
+    /**
+     * @brief Make the CalculateLayout calls running in other threads return early.
+     *
+     * Calls started afterwards are not affected. Blocks passed to an interrupted call are left
+     * partially laid out and must be discarded.
+     */
+    virtual void interrupt() { interruptions++; }
 
 protected:
     LayoutConfig layoutConfig;
+
+    /**
+     * @brief Get the value to pass to isInterrupted, taken when a CalculateLayout call starts
+     */
+    unsigned getInterruptions() const { return interruptions; }
+    /**
+     * @brief Check whether interrupt was called since getInterruptions returned startValue
+     */
+    bool isInterrupted(unsigned startValue) const { return interruptions != startValue; }
+
+private:
+    std::atomic<unsigned> interruptions { 0 };
 };
 
 #endif // GRAPHLAYOUT_H
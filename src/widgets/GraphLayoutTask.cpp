@@ -0,0 +1,21 @@
+#include "GraphLayoutTask.h"
+
+GraphLayoutTask::GraphLayoutTask(std::shared_ptr<GraphLayout> layout,
+                                 const GraphLayout::Graph &graph, ut64 entry)
+    : layout(std::move(layout)), graph(graph), entry(entry)
+{
+}
+
+void GraphLayoutTask::interrupt()
+{
+    AsyncTask::interrupt();
+    layout->interrupt();
+}
+
+void GraphLayoutTask::runTask()
+{
+    if (isInterrupted()) {
+        return;
+    }
+    layout->CalculateLayout(graph, entry, width, height);
+}
@@ -0,0 +1,41 @@
+#ifndef GRAPHLAYOUTTASK_H
+#define GRAPHLAYOUTTASK_H
+
+#include "common/AsyncTask.h"
+#include "widgets/GraphLayout.h"
+
+#include <memory>
+
+/**
+ * @brief Computes the placement of a graph in a background thread.
+ *
+ * Works on its own copy of the blocks, so the view can keep using its blocks while the layout is
+ * running. The result must be discarded if the task was interrupted.
+ */
+class GraphLayoutTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    GraphLayoutTask(std::shared_ptr<GraphLayout> layout, const GraphLayout::Graph &graph,
+                    ut64 entry);
+
+    QString getTitle() override { return tr("Computing graph layout"); }
+    void interrupt() override;
+
+    GraphLayout::Graph &getGraph() { return graph; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+protected:
+    void runTask() override;
+
+private:
+    std::shared_ptr<GraphLayout> layout;
+    GraphLayout::Graph graph;
+    ut64 entry;
+    int width = 0;
+    int height = 0;
+};
+
+#endif // GRAPHLAYOUTTASK_H
@@ -0,0 +1,106 @@
+#include "GraphSpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+void GraphSpatialIndex::build(const GraphLayout::Graph &graph)
+{
+    clear();
+    QRectF bounds;
+    for (auto &blockIt : graph) {
+        const auto &block = blockIt.second;
+        bounds |= QRectF(block.x, block.y, block.width, block.height);
+        for (const auto &edge : block.edges) {
+            if (!edge.polyline.empty()) {
+                bounds |= edge.polyline.boundingRect();
+            }
+        }
+    }
+    if (graph.empty()) {
+        return;
+    }
+
+    originX = bounds.x();
+    originY = bounds.y();
+    const int maxCells = MAX_CELLS;
+    cellSize = MIN_CELL_SIZE;
+    do {
+        columns = int(bounds.width() / cellSize) + 1;
+        rows = int(bounds.height() / cellSize) + 1;
+        if (qint64(columns) * rows <= maxCells) {
+            break;
+        }
+        cellSize *= 2;
+    } while (true);
+    cells.resize(size_t(columns) * size_t(rows));
+
+    for (auto &blockIt : graph) {
+        const auto &block = blockIt.second;
+        insert(QRectF(block.x, block.y, block.width, block.height), { block.entry, -1 });
+        for (size_t i = 0; i < block.edges.size(); i++) {
+            const QPolygonF &polyline = block.edges[i].polyline;
+            Item item { block.entry, int(i) };
+            if (polyline.size() == 1) {
+                insert(QRectF(polyline.first(), QSizeF(0, 0)), item);
+            }
+            for (int j = 1; j < polyline.size(); j++) {
+                insert(QRectF(polyline[j - 1], polyline[j]).normalized(), item);
+            }
+        }
+    }
+
+    // Consecutive segments of the same edge commonly share a cell
+    for (auto &cell : cells) {
+        std::sort(cell.begin(), cell.end());
+        cell.erase(std::unique(cell.begin(), cell.end()), cell.end());
+    }
+}
+
+void GraphSpatialIndex::clear()
+{
+    cells.clear();
+    columns = 0;
+    rows = 0;
+}
+
+void GraphSpatialIndex::insert(const QRectF &rect, Item item)
+{
+    QRect range = cellRange(rect);
+    for (int y = range.top(); y <= range.bottom(); y++) {
+        for (int x = range.left(); x <= range.right(); x++) {
+            cells[size_t(y) * size_t(columns) + size_t(x)].push_back(item);
+        }
+    }
+}
+
+QRect GraphSpatialIndex::cellRange(const QRectF &rect) const
+{
+    if (columns == 0 || rows == 0) {
+        return QRect();
+    }
+    qreal left = std::floor((rect.left() - originX) / cellSize);
+    qreal top = std::floor((rect.top() - originY) / cellSize);
+    qreal right = std::floor((rect.right() - originX) / cellSize);
+    qreal bottom = std::floor((rect.bottom() - originY) / cellSize);
+    if (right < 0 || bottom < 0 || left >= columns || top >= rows) {
+        return QRect();
+    }
+    return QRect(QPoint(int(std::max<qreal>(left, 0)), int(std::max<qreal>(top, 0))),
+                 QPoint(int(std::min<qreal>(right, columns - 1)),
+                        int(std::min<qreal>(bottom, rows - 1))));
+}
+
+std::vector<GraphSpatialIndex::Item> GraphSpatialIndex::query(const QRectF &rect) const
+{
+    std::vector<Item> result;
+    QRect range = cellRange(rect);
+    for (int y = range.top(); y <= range.bottom(); y++) {
+        for (int x = range.left(); x <= range.right(); x++) {
+            const auto &cell = cells[size_t(y) * size_t(columns) + size_t(x)];
+            result.insert(result.end(), cell.begin(), cell.end());
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
@@ -0,0 +1,70 @@
+#ifndef GRAPH_SPATIAL_INDEX_H
+#define GRAPH_SPATIAL_INDEX_H
+
+#include "core/Cutter.h"
+#include "GraphLayout.h"
+
+#include <QRectF>
+
+#include <vector>
+
+/**
+ * @brief Uniform grid over the blocks and edges of a laid out graph.
+ *
+ * Each block is registered in the cells covered by its rectangle and each edge in the cells
+ * covered by the bounding boxes of its polyline segments, so long edges going around the graph
+ * don't end up in every cell between their endpoints. Queries return candidates, callers still
+ * have to check the exact geometry.
+ */
+class GraphSpatialIndex
+{
+public:
+    struct Item
+    {
+        ut64 block;
+        /// Index into the edges of the block, or -1 for the block itself
+        int edge;
+
+        bool operator<(const Item &other) const
+        {
+            return block < other.block || (block == other.block && edge < other.edge);
+        }
+        bool operator==(const Item &other) const
+        {
+            return block == other.block && edge == other.edge;
+        }
+    };
+
+    /**
+     * @brief Rebuild the index from the current block positions and edge polylines.
+     */
+    void build(const GraphLayout::Graph &graph);
+    void clear();
+
+    /**
+     * @brief Get the items which may intersect with rect, without duplicates.
+     * @param rect area in logical graph coordinates
+     * @return items sorted by block, each block before its edges
+     */
+    std::vector<Item> query(const QRectF &rect) const;
+
+private:
+    static constexpr int MIN_CELL_SIZE = 512;
+    /// Upper bound for the number of cells, larger graphs get larger cells instead
+    static constexpr int MAX_CELLS = 1 << 18;
+
+    void insert(const QRectF &rect, Item item);
+    /**
+     * @return cells covered by rect clamped to the grid, empty if rect is outside of it
+     */
+    QRect cellRange(const QRectF &rect) const;
+
+    qreal originX = 0;
+    qreal originY = 0;
+    int cellSize = MIN_CELL_SIZE;
+    int columns = 0;
+    int rows = 0;
+    std::vector<std::vector<Item>> cells;
+};
+
+#endif // GRAPH_SPATIAL_INDEX_H
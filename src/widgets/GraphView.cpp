@@ -7,6 +7,7 @@
 #include "GraphHorizontalAdapter.h"
 #include "Helpers.h"
 
+#include <cmath>
 #include <vector>
 #include <QPainter>
 #include <QMouseEvent>
@@ -41,7 +42,10 @@ GraphView::GraphView(QWidget *parent)
     setGraphLayout(makeGraphLayout(Layout::GridMedium));
 }
 
-GraphView::~GraphView() {}
+GraphView::~GraphView()
+{
+    cancelGraphPlacement();
+}
 
 // Callbacks
 
@@ -81,6 +85,8 @@ void GraphView::blockTransitionedTo(GraphView::GraphBlock *to)
     Q_UNUSED(to);
 }
 
+void GraphView::graphPlacementComputed() {}
+
 GraphView::EdgeConfiguration GraphView::edgeConfiguration(GraphView::GraphBlock &from,
                                                           GraphView::GraphBlock *to,
                                                           bool interactive)
@@ -95,6 +101,11 @@ GraphView::EdgeConfiguration GraphView::edgeConfiguration(GraphView::GraphBlock
 
 void GraphView::blockContextMenuRequested(GraphView::GraphBlock &, QContextMenuEvent *, QPoint) {}
 
+void GraphView::drawSimplifiedBlock(QPainter &p, GraphView::GraphBlock &block)
+{
+    drawBlock(p, block, true);
+}
+
 bool GraphView::event(QEvent *event)
 {
     if (event->type() == QEvent::ToolTip) {
@@ -129,7 +140,76 @@ void GraphView::contextMenuEvent(QContextMenuEvent *event)
 
 void GraphView::computeGraphPlacement()
 {
+    cancelGraphPlacement();
     graphLayoutSystem->CalculateLayout(blocks, entry, width, height);
+    spatialIndex.build(blocks);
+    spatialIndexDirty = false;
+    setCacheDirty();
+    clampViewOffset();
+    viewport()->update();
+}
+
+void GraphView::computeGraphPlacementAsync()
+{
+    if (blocks.size() < ASYNC_LAYOUT_MIN_BLOCKS) {
+        computeGraphPlacement();
+        return;
+    }
+    cancelGraphPlacement();
+
+    layoutTask.reset(new GraphLayoutTask(graphLayoutSystem, blocks, entry));
+    QWeakPointer<GraphLayoutTask> weakTask = layoutTask;
+    connect(layoutTask.data(), &GraphLayoutTask::finished, this, [this, weakTask]() {
+        QSharedPointer<GraphLayoutTask> task = weakTask.toStrongRef();
+        if (!task || task != layoutTask) {
+            return;
+        }
+        layoutTask.reset();
+        if (!task->isInterrupted()) {
+            applyGraphPlacement(*task);
+        }
+    });
+    Core()->getAsyncTaskManager()->start(layoutTask);
+    viewport()->update();
+}
+
+void GraphView::cancelGraphPlacement(bool wait)
+{
+    if (!layoutTask) {
+        return;
+    }
+    layoutTask->interrupt();
+    if (wait) {
+        layoutTask->wait();
+    }
+    layoutTask.reset();
+    viewport()->update();
+}
+
+void GraphView::applyGraphPlacement(GraphLayoutTask &task)
+{
+    GraphLayout::Graph &placed = task.getGraph();
+    // Blocks might have been removed without starting a new layout
+    if (placed.size() != blocks.size()) {
+        return;
+    }
+    for (const auto &blockIt : blocks) {
+        if (placed.find(blockIt.first) == placed.end()) {
+            return;
+        }
+    }
+    setPlacedBlocks(std::move(placed), task.getWidth(), task.getHeight());
+    graphPlacementComputed();
+}
+
+void GraphView::setPlacedBlocks(GraphLayout::Graph graph, int width, int height)
+{
+    cancelGraphPlacement();
+    blocks = std::move(graph);
+    this->width = width;
+    this->height = height;
+    spatialIndex.build(blocks);
+    spatialIndexDirty = false;
     setCacheDirty();
     clampViewOffset();
     viewport()->update();
@@ -172,73 +252,156 @@ void GraphView::setViewScale(qreal scale)
     emit viewScaleChanged(scale);
 }
 
-QSize GraphView::getCacheSize()
+QSize GraphView::getRequiredCacheSize()
 {
-    return
-#ifndef CUTTER_NO_OPENGL_GRAPH
-            useGL ? cacheSize :
-#endif
-                  pixmap.size();
+    return viewport()->size() * qhelpers::devicePixelRatio(this);
 }
 
-qreal GraphView::getCacheDevicePixelRatioF()
+void GraphView::paintEvent(QPaintEvent *)
 {
-    return
+    if (layoutTask) {
+        // Block positions are not known yet
+        QPainter p(viewport());
+        p.fillRect(viewport()->rect(), backgroundColor);
+        p.drawText(viewport()->rect(), Qt::AlignCenter, tr("Computing layout..."));
+        return;
+    }
+    if (!useGL) {
+        QPainter p(viewport());
+        paintTiles(p);
+        return;
+    }
 #ifndef CUTTER_NO_OPENGL_GRAPH
-            useGL ? 1.0 :
+    glWidget->makeCurrent();
+
+    if (cacheSize != getRequiredCacheSize()) {
+        setCacheDirty();
+    }
+
+    if (cacheDirty) {
+        paintGraphCache();
+        cacheDirty = false;
+    }
+
+    auto gl = glWidget->context()->extraFunctions();
+    gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, cacheFBO);
+    gl->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, glWidget->defaultFramebufferObject());
+    auto dpr = qhelpers::devicePixelRatio(this);
+    gl->glBlitFramebuffer(0, 0, cacheSize.width(), cacheSize.height(), 0, 0,
+                          viewport()->width() * dpr, viewport()->height() * dpr,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glWidget->doneCurrent();
 #endif
-                  qhelpers::devicePixelRatio(&pixmap);
 }
 
-QSize GraphView::getRequiredCacheSize()
+void GraphView::paintTiles(QPainter &p)
 {
-    return viewport()->size() * qhelpers::devicePixelRatio(this);
+    qreal dpr = qhelpers::devicePixelRatio(this);
+    if (cacheDirty || !qFuzzyCompare(dpr, tileDevicePixelRatio)) {
+        clearTiles();
+        tileDevicePixelRatio = dpr;
+        cacheDirty = false;
+    }
+
+    // Tiles form a grid in view coordinates, which are logical coordinates multiplied by scale
+    const int tileSize = TILE_SIZE;
+    int originX = qRound(offset.x() * current_scale);
+    int originY = qRound(offset.y() * current_scale);
+    int firstColumn = int(std::floor(qreal(originX) / tileSize));
+    int firstRow = int(std::floor(qreal(originY) / tileSize));
+    int lastColumn = int(std::floor(qreal(originX + viewport()->width() - 1) / tileSize));
+    int lastRow = int(std::floor(qreal(originY + viewport()->height() - 1) / tileSize));
+
+    size_t visibleTiles = 0;
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            const QPixmap &tile = getTile({ current_scale, column, row });
+            p.drawPixmap(QPoint(column * tileSize - originX, row * tileSize - originY), tile);
+            visibleTiles++;
+        }
+    }
+
+    // Tiles of the current frame are the most recently used, so they are never evicted here
+    size_t tileBytes = size_t(tileSize * dpr) * size_t(tileSize * dpr) * 4;
+    size_t maxTiles = std::max<size_t>(MAX_TILE_CACHE_BYTES / tileBytes, visibleTiles);
+    while (tileLru.size() > maxTiles) {
+        tiles.erase(tileLru.back());
+        tileLru.pop_back();
+    }
 }
 
-qreal GraphView::getRequiredCacheDevicePixelRatioF()
+const QPixmap &GraphView::getTile(const TileKey &key)
 {
-    return
-#ifndef CUTTER_NO_OPENGL_GRAPH
-            useGL ? 1.0f :
-#endif
-                  qhelpers::devicePixelRatio(this);
+    auto it = tiles.find(key);
+    if (it != tiles.end()) {
+        tileLru.splice(tileLru.begin(), tileLru, it->second.lruIt);
+        return it->second.pixmap;
+    }
+
+    const int tileSize = TILE_SIZE;
+    QPixmap pixmap(QSize(tileSize, tileSize) * tileDevicePixelRatio);
+    pixmap.setDevicePixelRatio(tileDevicePixelRatio);
+    pixmap.fill(backgroundColor);
+    QPainter p(&pixmap);
+    p.setRenderHint(QPainter::Antialiasing);
+    QRectF window = tileRect(key);
+    p.scale(key.scale, key.scale);
+    p.translate(-window.topLeft());
+    paintWindow(p, window, key.scale, true);
+    p.end();
+
+    tileLru.push_front(key);
+    Tile &tile = tiles[key];
+    tile.pixmap = std::move(pixmap);
+    tile.lruIt = tileLru.begin();
+    return tile.pixmap;
 }
 
-void GraphView::paintEvent(QPaintEvent *)
+QRectF GraphView::tileRect(const TileKey &key)
 {
-#ifndef CUTTER_NO_OPENGL_GRAPH
-    if (useGL) {
-        glWidget->makeCurrent();
-    }
-#endif
+    const qreal size = TILE_SIZE / key.scale;
+    return QRectF(key.column * size, key.row * size, size, size);
+}
 
-    if (!qFuzzyCompare(getCacheDevicePixelRatioF(), getRequiredCacheDevicePixelRatioF())
-        || getCacheSize() != getRequiredCacheSize()) {
-        setCacheDirty();
-    }
+void GraphView::clearTiles()
+{
+    tiles.clear();
+    tileLru.clear();
+}
 
-    if (cacheDirty) {
-        paintGraphCache();
-        cacheDirty = false;
+void GraphView::invalidateArea(const QRectF &rect)
+{
+    for (auto it = tileLru.begin(); it != tileLru.end();) {
+        qreal margin = edgeMargin(it->scale);
+        if (tileRect(*it).intersects(rect.adjusted(-margin, -margin, margin, margin))) {
+            tiles.erase(*it);
+            it = tileLru.erase(it);
+        } else {
+            ++it;
+        }
     }
+    viewport()->update();
+}
 
-    if (useGL) {
-#ifndef CUTTER_NO_OPENGL_GRAPH
-        auto gl = glWidget->context()->extraFunctions();
-        gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, cacheFBO);
-        gl->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, glWidget->defaultFramebufferObject());
-        auto dpr = qhelpers::devicePixelRatio(this);
-        gl->glBlitFramebuffer(0, 0, cacheSize.width(), cacheSize.height(), 0, 0,
-                              viewport()->width() * dpr, viewport()->height() * dpr,
-                              GL_COLOR_BUFFER_BIT, GL_NEAREST);
-        glWidget->doneCurrent();
-#endif
-    } else {
-        QPainter p(viewport());
-        p.drawPixmap(QPoint(0, 0), pixmap);
+void GraphView::invalidateBlock(const GraphBlock &block)
+{
+    invalidateArea(QRectF(block.x, block.y, block.width, block.height));
+    for (auto &blockIt : blocks) {
+        for (const GraphEdge &edge : blockIt.second.edges) {
+            if ((blockIt.first == block.entry || edge.target == block.entry)
+                && !edge.polyline.empty()) {
+                invalidateArea(edge.polyline.boundingRect());
+            }
+        }
     }
 }
 
+qreal GraphView::edgeMargin(qreal scale)
+{
+    // Leave room for arrow heads and thick pens which stick out of the edge polylines
+    return std::max(10.0, 10 / scale);
+}
+
 void GraphView::clampViewOffset()
 {
     const qreal edgeFraction = 0.25;
@@ -267,10 +430,8 @@ void GraphView::paintGraphCache()
 {
 #ifndef CUTTER_NO_OPENGL_GRAPH
     std::unique_ptr<QOpenGLPaintDevice> paintDevice;
-#endif
     QPainter p;
-    if (useGL) {
-#ifndef CUTTER_NO_OPENGL_GRAPH
+    {
         auto gl = QOpenGLContext::currentContext()->functions();
 
         bool resizeTex = false;
@@ -306,25 +467,16 @@ void GraphView::paintGraphCache()
 
         paintDevice.reset(new QOpenGLPaintDevice(cacheSize));
         p.begin(paintDevice.get());
-#endif
-    } else {
-        auto dpr = qhelpers::devicePixelRatio(this);
-        pixmap = QPixmap(getRequiredCacheSize() * dpr);
-        pixmap.setDevicePixelRatio(dpr);
-        pixmap.fill(backgroundColor);
-        p.begin(&pixmap);
-        p.setRenderHint(QPainter::Antialiasing);
-        p.setViewport(this->viewport()->rect());
     }
     paint(p, offset, this->viewport()->rect(), current_scale);
 
     p.end();
+#endif
 }
 
 void GraphView::paint(QPainter &p, QPoint offset, QRect viewport, qreal scale, bool interactive)
 {
     QPointF offsetF(offset.x(), offset.y());
-    p.setBrush(Qt::black);
 
     int render_width = viewport.width();
     int render_height = viewport.height();
@@ -333,84 +485,136 @@ void GraphView::paint(QPainter &p, QPoint offset, QRect viewport, qreal scale, b
     QRect window =
             QRect(offset, QSize(qRound(render_width / scale), qRound(render_height / scale)));
     p.setWindow(window);
-    QRectF windowF(window.x(), window.y(), window.width(), window.height());
+    paintWindow(p, QRectF(window), scale, interactive);
+}
 
-    for (auto &blockIt : blocks) {
-        GraphBlock &block = blockIt.second;
+void GraphView::paintWindow(QPainter &p, const QRectF &windowF, qreal scale, bool interactive)
+{
+    p.setBrush(Qt::black);
 
-        QRectF blockRect(block.x, block.y, block.width, block.height);
+    if (!interactive) {
+        detailLevel = DetailLevel::Full;
+    } else if (scale < simplifiedEdgeScale) {
+        detailLevel = DetailLevel::SimplifiedEdges;
+    } else if (scale < simplifiedBlockScale) {
+        detailLevel = DetailLevel::SimplifiedBlocks;
+    } else {
+        detailLevel = DetailLevel::Full;
+    }
 
-        // Check if block is visible by checking if block intersects with view area
-        if (blockRect.intersects(windowF)) {
-            drawBlock(p, block, interactive);
+    updateSpatialIndex();
+    const qreal margin = edgeMargin(scale);
+    QRectF edgeWindow = windowF.adjusted(-margin, -margin, margin, margin);
+
+    // Items are sorted by block, so the edges of a block are drawn right after the block itself
+    for (const GraphSpatialIndex::Item &item : spatialIndex.query(edgeWindow)) {
+        auto blockIt = blocks.find(item.block);
+        if (blockIt == blocks.end()) {
+            continue;
         }
+        GraphBlock &block = blockIt->second;
 
-        p.setBrush(Qt::gray);
+        if (item.edge < 0) {
+            QRectF blockRect(block.x, block.y, block.width, block.height);
 
-        // Always draw edges
-        // TODO: Only draw edges if they are actually visible ...
-        // Draw edges
-        for (GraphEdge &edge : block.edges) {
-            if (edge.polyline.empty()) {
+            // Check if block is visible by checking if block intersects with view area
+            if (!blockRect.intersects(windowF)) {
                 continue;
             }
-            QPolygonF polyline = edge.polyline;
-            EdgeConfiguration ec = edgeConfiguration(block, &blocks[edge.target], interactive);
-            QPen pen(ec.color);
-            pen.setStyle(ec.lineStyle);
-            pen.setWidthF(pen.width() * ec.width_scale);
-            if (scale_thickness_multiplier && ec.width_scale > 1.01 && pen.widthF() * scale < 2) {
-                pen.setWidthF(ec.width_scale / scale);
-            }
-            if (pen.widthF() * scale < 2) {
-                pen.setWidth(0);
-            }
-            p.setPen(pen);
-            p.setBrush(ec.color);
-            p.drawPolyline(polyline);
-            pen.setStyle(Qt::SolidLine);
-            p.setPen(pen);
-
-            auto drawArrow = [&](QPointF tip, QPointF dir) {
-                pen.setWidth(0);
-                p.setPen(pen);
-                QPolygonF arrow;
-                arrow << tip;
-                QPointF dy(-dir.y(), dir.x());
-                QPointF base = tip - dir * 6;
-                arrow << base + 3 * dy;
-                arrow << base - 3 * dy;
-                p.drawConvexPolygon(arrow);
-            };
-
-            if (!polyline.empty()) {
-                if (ec.start_arrow) {
-                    auto firstPt = edge.polyline.first();
-                    drawArrow(firstPt, QPointF(0, 1));
-                }
-                if (ec.end_arrow) {
-                    auto lastPt = edge.polyline.last();
-                    QPointF dir(0, -1);
-                    switch (edge.arrow) {
-                    case GraphLayout::GraphEdge::Down:
-                        dir = QPointF(0, 1);
-                        break;
-                    case GraphLayout::GraphEdge::Up:
-                        dir = QPointF(0, -1);
-                        break;
-                    case GraphLayout::GraphEdge::Left:
-                        dir = QPointF(-1, 0);
-                        break;
-                    case GraphLayout::GraphEdge::Right:
-                        dir = QPointF(1, 0);
-                        break;
-                    default:
-                        break;
-                    }
-                    drawArrow(lastPt, dir);
-                }
+            if (detailLevel == DetailLevel::Full) {
+                drawBlock(p, block, interactive);
+            } else {
+                drawSimplifiedBlock(p, block);
             }
+            continue;
+        }
+
+        if (size_t(item.edge) >= block.edges.size()) {
+            continue;
+        }
+        GraphEdge &edge = block.edges[size_t(item.edge)];
+        if (edge.polyline.empty()
+            || !edge.polyline.boundingRect()
+                        .adjusted(-margin, -margin, margin, margin)
+                        .intersects(windowF)) {
+            continue;
+        }
+        p.setBrush(Qt::gray);
+        drawEdge(p, block, edge, scale, interactive);
+    }
+}
+
+void GraphView::drawEdge(QPainter &p, GraphBlock &block, GraphEdge &edge, qreal scale,
+                         bool interactive)
+{
+    const QPolygonF &polyline = edge.polyline;
+    EdgeConfiguration ec = edgeConfiguration(block, &blocks[edge.target], interactive);
+    if (detailLevel == DetailLevel::SimplifiedEdges) {
+        QPen pen(ec.color, 0);
+        pen.setStyle(ec.lineStyle);
+        p.setPen(pen);
+        p.drawLine(polyline.first(), polyline.last());
+        return;
+    }
+    QPen pen(ec.color);
+    pen.setStyle(ec.lineStyle);
+    pen.setWidthF(pen.width() * ec.width_scale);
+    if (scale_thickness_multiplier && ec.width_scale > 1.01 && pen.widthF() * scale < 2) {
+        pen.setWidthF(ec.width_scale / scale);
+    }
+    if (pen.widthF() * scale < 2) {
+        pen.setWidth(0);
+    }
+    p.setPen(pen);
+    p.setBrush(ec.color);
+    p.drawPolyline(polyline);
+    pen.setStyle(Qt::SolidLine);
+    p.setPen(pen);
+
+    auto drawArrow = [&](QPointF tip, QPointF dir) {
+        pen.setWidth(0);
+        p.setPen(pen);
+        QPolygonF arrow;
+        arrow << tip;
+        QPointF dy(-dir.y(), dir.x());
+        QPointF base = tip - dir * 6;
+        arrow << base + 3 * dy;
+        arrow << base - 3 * dy;
+        p.drawConvexPolygon(arrow);
+    };
+
+    if (ec.start_arrow) {
+        auto firstPt = polyline.first();
+        drawArrow(firstPt, QPointF(0, 1));
+    }
+    if (ec.end_arrow) {
+        auto lastPt = polyline.last();
+        QPointF dir(0, -1);
+        switch (edge.arrow) {
+        case GraphLayout::GraphEdge::Down:
+            dir = QPointF(0, 1);
+            break;
+        case GraphLayout::GraphEdge::Up:
+            dir = QPointF(0, -1);
+            break;
+        case GraphLayout::GraphEdge::Left:
+            dir = QPointF(-1, 0);
+            break;
+        case GraphLayout::GraphEdge::Right:
+            dir = QPointF(1, 0);
+            break;
+        default:
+            break;
         }
+        drawArrow(lastPt, dir);
+    }
+}
+
+void GraphView::updateSpatialIndex()
+{
+    if (spatialIndexDirty) {
+        spatialIndex.build(blocks);
+        spatialIndexDirty = false;
     }
 }
 
@@ -508,9 +712,17 @@ void GraphView::showRectangle(const QRect &block, bool anywhere)
 
 GraphView::GraphBlock *GraphView::getBlockContaining(QPoint p)
 {
+    if (layoutTask) {
+        return nullptr;
+    }
+    updateSpatialIndex();
     // Check if a block was clicked
-    for (auto &blockIt : blocks) {
-        GraphBlock &block = blockIt.second;
+    for (const GraphSpatialIndex::Item &item : spatialIndex.query(QRectF(p, QSizeF(0, 0)))) {
+        auto blockIt = blocks.find(item.block);
+        if (item.edge >= 0 || blockIt == blocks.end()) {
+            continue;
+        }
+        GraphBlock &block = blockIt->second;
 
         QRect rec(block.x, block.y, block.width, block.height);
         if (rec.contains(p)) {
@@ -532,6 +744,7 @@ QPoint GraphView::logicalToViewCoordinates(QPoint p)
 
 void GraphView::setGraphLayout(std::unique_ptr<GraphLayout> layout)
 {
+    cancelGraphPlacement();
     graphLayoutSystem = std::move(layout);
     if (!graphLayoutSystem) {
         graphLayoutSystem = makeGraphLayout(Layout::GridMedium);
@@ -540,9 +753,23 @@ void GraphView::setGraphLayout(std::unique_ptr<GraphLayout> layout)
 
 void GraphView::setLayoutConfig(const GraphLayout::LayoutConfig &config)
 {
+    // The running layout reads the configuration
+    cancelGraphPlacement(true);
     graphLayoutSystem->setLayoutConfig(config);
 }
 
+void GraphView::setDetailLevelScales(qreal blockScale, qreal edgeScale)
+{
+    if (qFuzzyCompare(1 + blockScale, 1 + simplifiedBlockScale)
+        && qFuzzyCompare(1 + edgeScale, 1 + simplifiedEdgeScale)) {
+        return;
+    }
+    simplifiedBlockScale = blockScale;
+    simplifiedEdgeScale = edgeScale;
+    setCacheDirty();
+    viewport()->update();
+}
+
 std::unique_ptr<GraphLayout> GraphView::makeGraphLayout(GraphView::Layout layout, bool horizontal)
 {
     std::unique_ptr<GraphLayout> result;
@@ -611,7 +838,9 @@ std::unique_ptr<GraphLayout> GraphView::makeGraphLayout(GraphView::Layout layout
 
 void GraphView::addBlock(GraphView::GraphBlock block)
 {
+    cancelGraphPlacement();
     blocks[block.entry] = block;
+    spatialIndexDirty = true;
 }
 
 void GraphView::setEntry(ut64 e)
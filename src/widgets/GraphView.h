@@ -14,9 +14,12 @@
 #include <unordered_set>
 #include <queue>
 #include <memory>
+#include <list>
 
 #include "core/Cutter.h"
 #include "widgets/GraphLayout.h"
+#include "widgets/GraphSpatialIndex.h"
+#include "widgets/GraphLayoutTask.h"
 
 #if defined(QT_NO_OPENGL) || QT_VERSION < QT_VERSION_CHECK(5, 6, 0)
 // QOpenGLExtraFunctions were introduced in 5.6
@@ -63,6 +66,17 @@ public:
     };
     static std::unique_ptr<GraphLayout> makeGraphLayout(Layout layout, bool horizontal = false);
 
+    /**
+     * @brief Amount of detail drawn, chosen by zoom level
+     */
+    enum class DetailLevel {
+        Full,
+        /// Blocks are drawn by drawSimplifiedBlock
+        SimplifiedBlocks,
+        /// Blocks are simplified and edges are drawn as straight lines without arrows
+        SimplifiedEdges
+    };
+
     struct EdgeConfiguration
     {
         QColor color = QColor(128, 128, 128);
@@ -94,6 +108,15 @@ public:
     void setGraphLayout(std::unique_ptr<GraphLayout> layout);
     GraphLayout &getGraphLayout() const { return *graphLayoutSystem; }
     void setLayoutConfig(const GraphLayout::LayoutConfig &config);
+    /**
+     * @brief Set the zoom levels below which the graph is drawn with less detail.
+     *
+     * Both are 0 by default, which disables simplified drawing. Exports are always drawn in full
+     * detail.
+     * @param blockScale scale below which blocks are simplified
+     * @param edgeScale scale below which edges are simplified too
+     */
+    void setDetailLevelScales(qreal blockScale, qreal edgeScale);
 
     void paint(QPainter &p, QPoint offset, QRect area, qreal scale = 1.0, bool interactive = true);
 
@@ -102,6 +125,18 @@ public:
     void saveAsSvg(QString path);
 
     void computeGraphPlacement();
+    /**
+     * @brief Compute the placement of large graphs in a background task.
+     *
+     * Small graphs are placed immediately like computeGraphPlacement does. For larger ones a
+     * placeholder is shown until the layout is done, then graphPlacementComputed is called. A
+     * layout still running is cancelled when the blocks or the layout change.
+     */
+    void computeGraphPlacementAsync();
+    /**
+     * @return whether a placement started by computeGraphPlacementAsync has not finished yet
+     */
+    bool isGraphPlacementPending() const { return !layoutTask.isNull(); }
 
     /**
      * @brief Remove duplicate edges and edges without target in graph.
@@ -117,9 +152,33 @@ protected:
     // Padding inside the block
     int block_padding = 16;
 
+    /**
+     * @brief Throw away everything rendered so far, the whole graph is redrawn on the next paint.
+     */
     void setCacheDirty() { cacheDirty = true; }
+    /**
+     * @brief Redraw the cached tiles overlapping with an area on the next paint.
+     * @param rect area in logical coordinates
+     */
+    void invalidateArea(const QRectF &rect);
+    /**
+     * @brief Redraw a block and all edges from and to it on the next paint.
+     */
+    void invalidateBlock(const GraphBlock &block);
 
     void addBlock(GraphView::GraphBlock block);
+    /**
+     * @brief Stop the placement started by computeGraphPlacementAsync, its result is discarded.
+     * @param wait - block until the layout thread has returned
+     */
+    void cancelGraphPlacement(bool wait = false);
+    /**
+     * @brief Replace all blocks by blocks which were already placed, skipping the layout.
+     * @param graph blocks with positions and edge polylines computed by a previous layout
+     * @param width width of the whole graph
+     * @param height height of the whole graph
+     */
+    void setPlacedBlocks(GraphLayout::Graph graph, int width, int height);
     void setEntry(ut64 e);
 
     // Callbacks that should be overridden
@@ -130,11 +189,26 @@ protected:
      * @param interactive - can be used for disabling elemnts during export
      */
     virtual void drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive = true) = 0;
+    /**
+     * @brief Draw a block when zoomed out too far for its content to be readable.
+     *
+     * Should be independent of the amount of content in the block. The default implementation
+     * falls back to drawBlock.
+     */
+    virtual void drawSimplifiedBlock(QPainter &p, GraphView::GraphBlock &block);
+    /**
+     * @brief Detail level of the paint in progress, can be used by drawBlock and edgeConfiguration
+     */
+    DetailLevel getDetailLevel() const { return detailLevel; }
     virtual void blockClicked(GraphView::GraphBlock &block, QMouseEvent *event, QPoint pos);
     virtual void blockDoubleClicked(GraphView::GraphBlock &block, QMouseEvent *event, QPoint pos);
     virtual void blockHelpEvent(GraphView::GraphBlock &block, QHelpEvent *event, QPoint pos);
     virtual bool helpEvent(QHelpEvent *event);
     virtual void blockTransitionedTo(GraphView::GraphBlock *to);
+    /**
+     * @brief Called after a placement computed in the background has been applied to the blocks.
+     */
+    virtual void graphPlacementComputed();
     virtual void wheelEvent(QWheelEvent *event) override;
     virtual EdgeConfiguration edgeConfiguration(GraphView::GraphBlock &from,
                                                 GraphView::GraphBlock *to, bool interactive = true);
@@ -177,6 +251,11 @@ private:
     void centerY(bool emitSignal);
 
     void paintGraphCache();
+    void paintWindow(QPainter &p, const QRectF &window, qreal scale, bool interactive);
+    static qreal edgeMargin(qreal scale);
+    void drawEdge(QPainter &p, GraphBlock &block, GraphEdge &edge, qreal scale, bool interactive);
+    void updateSpatialIndex();
+    void applyGraphPlacement(GraphLayoutTask &task);
 
     bool checkPointClicked(QPointF &point, int x, int y, bool above_y = false);
 
@@ -187,7 +266,22 @@ private:
 
     ut64 entry = 0;
 
-    std::unique_ptr<GraphLayout> graphLayoutSystem;
+    /// Shared with a GraphLayoutTask while a layout is running in the background
+    std::shared_ptr<GraphLayout> graphLayoutSystem;
+    QSharedPointer<GraphLayoutTask> layoutTask;
+    /// Graphs with fewer blocks are always placed synchronously
+    static constexpr size_t ASYNC_LAYOUT_MIN_BLOCKS = 200;
+
+    /**
+     * @brief Index of block and edge positions used for skipping everything outside of the
+     * painted area, rebuilt after the placement was computed.
+     */
+    GraphSpatialIndex spatialIndex;
+    bool spatialIndexDirty = true;
+
+    qreal simplifiedBlockScale = 0;
+    qreal simplifiedEdgeScale = 0;
+    DetailLevel detailLevel = DetailLevel::Full;
 
     QPoint scrollBase;
     bool scroll_mode = false;
@@ -195,9 +289,52 @@ private:
     bool useGL;
 
     /**
-     * @brief pixmap that caches the graph nodes
+     * @brief Square area of the graph rendered at a specific scale.
+     *
+     * Column and row are counted in TILE_SIZE steps of view coordinates, which are logical
+     * coordinates multiplied by the scale.
+     */
+    struct TileKey
+    {
+        qreal scale;
+        int column;
+        int row;
+
+        bool operator==(const TileKey &other) const
+        {
+            return scale == other.scale && column == other.column && row == other.row;
+        }
+    };
+    struct TileKeyHash
+    {
+        size_t operator()(const TileKey &key) const
+        {
+            size_t hash = std::hash<qreal>()(key.scale);
+            hash = hash * 31 + std::hash<int>()(key.column);
+            return hash * 31 + std::hash<int>()(key.row);
+        }
+    };
+    struct Tile
+    {
+        QPixmap pixmap;
+        std::list<TileKey>::iterator lruIt;
+    };
+
+    static constexpr int TILE_SIZE = 256;
+    static constexpr size_t MAX_TILE_CACHE_BYTES = 128 * 1024 * 1024;
+
+    /**
+     * @brief Rendered tiles, shared by all scales and evicted in LRU order
      */
-    QPixmap pixmap;
+    std::unordered_map<TileKey, Tile, TileKeyHash> tiles;
+    /// Most recently used first
+    std::list<TileKey> tileLru;
+    qreal tileDevicePixelRatio = 1.0;
+
+    void paintTiles(QPainter &p);
+    const QPixmap &getTile(const TileKey &key);
+    static QRectF tileRect(const TileKey &key);
+    void clearTiles();
 
 #ifndef CUTTER_NO_OPENGL_GRAPH
     uint32_t cacheTexture;
@@ -210,10 +347,7 @@ private:
      * @brief flag to control if the cache is invalid and should be re-created in the next draw
      */
     bool cacheDirty = true;
-    QSize getCacheSize();
-    qreal getCacheDevicePixelRatioF();
     QSize getRequiredCacheSize();
-    qreal getRequiredCacheDevicePixelRatioF();
 
     void beginMouseDrag(QMouseEvent *event);
 
@@ -11,6 +11,12 @@
 
 #include <gvc.h>
 
+#include <QMutex>
+#include <QMutexLocker>
+
+/// Graphviz is not reentrant, layouts running in different threads must not overlap
+static QMutex graphvizMutex;
+
 GraphvizLayout::GraphvizLayout(LayoutType lineType, Direction direction)
     : GraphLayout({}), direction(direction), layoutType(lineType)
 {
@@ -88,7 +94,13 @@ void GraphvizLayout::CalculateLayout(std::unordered_map<ut64, GraphBlock> &block
     // https://gitlab.com/graphviz/graphviz/issues/1441
 #define STR(v) const_cast<char *>(v)
 
+    const unsigned interruptions = getInterruptions();
     width = height = 10;
+    QMutexLocker locker(&graphvizMutex);
+    // The layout may have been interrupted while waiting for another one
+    if (isInterrupted(interruptions)) {
+        return;
+    }
     GVC_t *gvc = gvContext();
     Agraph_t *g = agopen(STR("G"), Agdirected, nullptr);
 
@@ -174,6 +186,12 @@ void GraphvizLayout::CalculateLayout(std::unordered_map<ut64, GraphBlock> &block
     }
 
     gvLayout(gvc, g, layoutEngine);
+    if (isInterrupted(interruptions)) {
+        gvFreeLayout(gvc, g);
+        agclose(g);
+        gvFreeContext(gvc);
+        return;
+    }
 
     for (auto &blockIt : blocks) {
         auto &block = blockIt.second;
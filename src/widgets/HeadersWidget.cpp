@@ -79,40 +79,48 @@ QString HeadersModel::name(const QModelIndex &index) const
     return header.name;
 }
 
+const HeaderDescription *HeadersModel::description(QModelIndex index) const
+{
+    if (index.row() < headers->size()) {
+        return &headers->at(index.row());
+    }
+    return nullptr;
+}
+
 HeadersProxyModel::HeadersProxyModel(HeadersModel *sourceModel, QObject *parent)
     : AddressableFilterProxyModel(sourceModel, parent)
 {
+    setCommentColumn(HeadersModel::CommentColumn);
 }
 
 bool HeadersProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
 {
-    QModelIndex index = sourceModel()->index(row, 0, parent);
-    HeaderDescription item =
-            index.data(HeadersModel::HeaderDescriptionRole).value<HeaderDescription>();
-    return qhelpers::filterStringContains(item.name, this);
+    auto source = static_cast<HeadersModel *>(sourceModel());
+    QModelIndex index = source->index(row, 0, parent);
+    const HeaderDescription *item = source->description(index);
+    return qhelpers::filterStringContains(item->name, this);
 }
 
 bool HeadersProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
-    HeaderDescription leftHeader =
-            left.data(HeadersModel::HeaderDescriptionRole).value<HeaderDescription>();
-    HeaderDescription rightHeader =
-            right.data(HeadersModel::HeaderDescriptionRole).value<HeaderDescription>();
+    auto source = static_cast<HeadersModel *>(sourceModel());
+    const HeaderDescription *leftHeader = source->description(left);
+    const HeaderDescription *rightHeader = source->description(right);
 
     switch (left.column()) {
     case HeadersModel::OffsetColumn:
-        return leftHeader.vaddr < rightHeader.vaddr;
+        return leftHeader->vaddr < rightHeader->vaddr;
     case HeadersModel::NameColumn:
-        return leftHeader.name < rightHeader.name;
+        return leftHeader->name < rightHeader->name;
     case HeadersModel::ValueColumn:
-        return leftHeader.value < rightHeader.value;
+        return leftHeader->value < rightHeader->value;
     case HeadersModel::CommentColumn:
-        return Core()->getCommentAt(leftHeader.vaddr) < Core()->getCommentAt(rightHeader.vaddr);
+        return AddressableFilterProxyModel::lessThan(left, right);
     default:
         break;
     }
 
-    return leftHeader.vaddr < rightHeader.vaddr;
+    return leftHeader->vaddr < rightHeader->vaddr;
 }
 
 HeadersWidget::HeadersWidget(MainWindow *main) : ListDockWidget(main)
@@ -44,6 +44,8 @@ public:
 
     RVA address(const QModelIndex &index) const override;
     QString name(const QModelIndex &index) const override;
+
+    const HeaderDescription *description(QModelIndex index) const;
 };
 
 class HeadersProxyModel : public AddressableFilterProxyModel
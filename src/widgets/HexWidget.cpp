@@ -28,6 +28,113 @@ static constexpr int MAX_LINE_WIDTH_PRESET = 32;
 static constexpr int MAX_LINE_WIDTH_BYTES = 128 * 1024;
 static constexpr int WARNING_TIME_MS = 500;
 
+HexBlockCache::HexBlockCache(QObject *parent) : QObject(parent) {}
+
+HexBlockCache::~HexBlockCache()
+{
+    cancelPrefetch();
+}
+
+QByteArray HexBlockCache::block(uint64_t blockAddr)
+{
+    auto it = blocks.find(blockAddr);
+    if (it != blocks.end()) {
+        lru.splice(lru.begin(), lru, it->lruPos);
+        return it->data;
+    }
+    QByteArray data = Core()->ioRead(blockAddr, BLOCK_SIZE);
+    insert(blockAddr, data);
+    return data;
+}
+
+void HexBlockCache::insert(uint64_t blockAddr, const QByteArray &data)
+{
+    auto it = blocks.find(blockAddr);
+    if (it != blocks.end()) {
+        it->data = data;
+        lru.splice(lru.begin(), lru, it->lruPos);
+        return;
+    }
+    lru.push_front(blockAddr);
+    blocks.insert(blockAddr, { data, lru.begin() });
+    while (blocks.size() > MAX_BLOCKS) {
+        blocks.remove(lru.back());
+        lru.pop_back();
+    }
+}
+
+void HexBlockCache::prefetchAround(uint64_t firstBlockAddr, uint64_t lastBlockAddr)
+{
+    QVector<uint64_t> missing;
+    for (int i = 1; i <= PREFETCH_BLOCKS; i++) {
+        uint64_t distance = uint64_t(i) * BLOCK_SIZE;
+        if (lastBlockAddr <= UINT64_MAX - distance && !blocks.contains(lastBlockAddr + distance)) {
+            missing.append(lastBlockAddr + distance);
+        }
+        if (firstBlockAddr >= distance && !blocks.contains(firstBlockAddr - distance)) {
+            missing.append(firstBlockAddr - distance);
+        }
+    }
+    if (missing.isEmpty()) {
+        return;
+    }
+
+    cancelPrefetch();
+    prefetchTask.reset(new HexBlockPrefetchTask(missing, BLOCK_SIZE));
+    QWeakPointer<HexBlockPrefetchTask> weakTask = prefetchTask;
+    quint64 taskGeneration = generation;
+    connect(prefetchTask.data(), &AsyncTask::finished, this, [this, weakTask, taskGeneration]() {
+        auto task = weakTask.toStrongRef();
+        if (!task || task != prefetchTask || taskGeneration != generation) {
+            return;
+        }
+        const auto &addresses = task->getBlockAddresses();
+        const auto &data = task->getBlocks();
+        for (int i = 0; i < data.size(); i++) {
+            if (!blocks.contains(addresses[i])) {
+                insert(addresses[i], data[i]);
+            }
+        }
+        prefetchTask.clear();
+    });
+    Core()->getAsyncTaskManager()->start(prefetchTask);
+}
+
+void HexBlockCache::cancelPrefetch()
+{
+    if (prefetchTask) {
+        prefetchTask->interrupt();
+        prefetchTask.clear();
+    }
+}
+
+void HexBlockCache::invalidate()
+{
+    generation++;
+    cancelPrefetch();
+    blocks.clear();
+    lru.clear();
+}
+
+void HexBlockCache::invalidate(uint64_t addr, uint64_t len)
+{
+    if (len == 0) {
+        return;
+    }
+    generation++;
+    cancelPrefetch();
+    uint64_t first = addr & ~(BLOCK_SIZE - 1);
+    uint64_t last = len - 1 > UINT64_MAX - addr ? UINT64_MAX : addr + (len - 1);
+    for (auto it = lru.begin(); it != lru.end();) {
+        if (*it >= first && *it <= last) {
+            blocks.remove(*it);
+            it = lru.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 HexWidget::HexWidget(QWidget *parent)
     : QScrollArea(parent),
       cursorEnabled(true),
@@ -52,6 +159,19 @@ HexWidget::HexWidget(QWidget *parent)
             [this]() { viewport()->update(); });
 
     connect(Config(), &Configuration::colorsUpdated, this, &HexWidget::updateColors);
+    connect(Core(), &CutterCore::flagsChanged, this, [this]() {
+        updateAnnotations();
+        viewport()->update();
+    });
+    connect(Core(), &CutterCore::commentsChanged, this, [this]() {
+        updateAnnotations();
+        viewport()->update();
+    });
+    connect(Core(), &CutterCore::instructionChanged, this, [this](RVA offset, RVA size) {
+        blockCache->invalidate(offset, size);
+        refreshData();
+    });
+    connect(Core(), &CutterCore::ioCacheChanged, this, &HexWidget::refresh);
     connect(Config(), &Configuration::fontsUpdated, this,
             [this]() { setMonospaceFont(Config()->getFont()); });
 
@@ -198,8 +318,9 @@ HexWidget::HexWidget(QWidget *parent)
 
     startAddress = 0ULL;
     cursor.address = 0ULL;
-    data.reset(new MemoryData());
-    oldData.reset(new MemoryData());
+    blockCache = new HexBlockCache(this);
+    data.reset(new MemoryData(blockCache));
+    oldData.reset(new MemoryData(blockCache));
 
     fetchData();
     updateCursorMeta();
@@ -425,6 +546,12 @@ void HexWidget::seek(uint64_t address)
 }
 
 void HexWidget::refresh()
+{
+    blockCache->invalidate();
+    refreshData();
+}
+
+void HexWidget::refreshData()
 {
     fetchData();
     viewport()->update();
@@ -529,7 +656,7 @@ void HexWidget::mouseMoveEvent(QMouseEvent *event)
 
     auto mouseAddr = mousePosToAddr(pos).address;
 
-    QString metaData = getFlagsAndComment(mouseAddr);
+    QString metaData = hasAnnotationAt(mouseAddr) ? getFlagsAndComment(mouseAddr) : QString();
     if (!metaData.isEmpty() && itemArea.contains(pos)) {
         QToolTip::showText(mapToGlobal(event->pos()), metaData.replace(",", ", "), this);
     } else {
@@ -1274,10 +1401,13 @@ void HexWidget::w_writeString()
     if (!ok || str.isEmpty()) {
         return;
     }
+    const RVA address = getLocationAddress();
+    const QByteArray utf8 = str.toUtf8();
     {
         RzCoreLocked core(Core());
-        rz_core_write_string_at(core, getLocationAddress(), str.toUtf8().constData());
+        rz_core_write_string_at(core, address, utf8.constData());
     }
+    emit Core()->instructionChanged(address, utf8.size());
     refresh();
 }
 
@@ -1296,10 +1426,12 @@ void HexWidget::w_increaseDecrease()
     if (d.getMode() == IncrementDecrementDialog::Decrease) {
         value *= -1;
     }
+    const RVA address = getLocationAddress();
     {
         RzCoreLocked core(Core());
-        rz_core_write_value_inc_at(core, getLocationAddress(), value, sz);
+        rz_core_write_value_inc_at(core, address, value, sz);
     }
+    emit Core()->instructionChanged(address, sz);
     refresh();
 }
 
@@ -1336,6 +1468,7 @@ void HexWidget::w_writeBytes()
         rz_core_write_at(core, getLocationAddress(), buf, bytes_size);
         free(buf);
     }
+    emit Core()->instructionChanged(getLocationAddress(), bytes_size);
     refresh();
 }
 
@@ -1384,14 +1517,19 @@ void HexWidget::w_write64()
         return;
     }
 
+    const RVA address = getLocationAddress();
+    RVA size;
     {
         RzCoreLocked core(Core());
         if (d.getMode() == Base64EnDecodedWriteDialog::Encode) {
-            rz_core_write_base64_at(core, getLocationAddress(), str.toHex().constData());
+            rz_core_write_base64_at(core, address, str.toHex().constData());
+            size = (str.size() + 2) / 3 * 4;
         } else {
-            rz_core_write_base64d_at(core, getLocationAddress(), str.constData());
+            rz_core_write_base64d_at(core, address, str.constData());
+            size = str.size() / 4 * 3;
         }
     }
+    emit Core()->instructionChanged(address, size);
     refresh();
 }
 
@@ -1413,10 +1551,12 @@ void HexWidget::w_writeRandom()
         return;
     }
 
+    const RVA address = getLocationAddress();
     {
         RzCoreLocked core(Core());
-        rz_core_write_random_at(core, getLocationAddress(), nbytes);
+        rz_core_write_random_at(core, address, nbytes);
     }
+    emit Core()->instructionChanged(address, nbytes);
     refresh();
 }
 
@@ -1432,10 +1572,12 @@ void HexWidget::w_duplFromOffset()
     }
     RVA src = d.getOffset();
     int len = (int)d.getNBytes();
+    const RVA address = getLocationAddress();
     {
         RzCoreLocked core(Core());
-        rz_core_write_duplicate_at(core, getLocationAddress(), src, len);
+        rz_core_write_duplicate_at(core, address, src, len);
     }
+    emit Core()->instructionChanged(address, len);
     refresh();
 }
 
@@ -1450,10 +1592,13 @@ void HexWidget::w_writePascalString()
     if (!ok || str.isEmpty()) {
         return;
     }
+    const RVA address = getLocationAddress();
+    const QByteArray utf8 = str.toUtf8();
     {
         RzCoreLocked core(Core());
-        rz_core_write_length_string_at(core, getLocationAddress(), str.toUtf8().constData());
+        rz_core_write_length_string_at(core, address, utf8.constData());
     }
+    emit Core()->instructionChanged(address, 1 + utf8.size());
     refresh();
 }
 
@@ -1468,10 +1613,13 @@ void HexWidget::w_writeWideString()
     if (!ok || str.isEmpty()) {
         return;
     }
+    const RVA address = getLocationAddress();
+    const QByteArray utf8 = str.toUtf8();
     {
         RzCoreLocked core(Core());
-        rz_core_write_string_wide_at(core, getLocationAddress(), str.toUtf8().constData());
+        rz_core_write_string_wide_at(core, address, utf8.constData());
     }
+    emit Core()->instructionChanged(address, 2 * utf8.size());
     refresh();
 }
 
@@ -1486,10 +1634,13 @@ void HexWidget::w_writeCString()
     if (!ok || str.isEmpty()) {
         return;
     }
+    const RVA address = getLocationAddress();
+    const QByteArray utf8 = str.toUtf8();
     {
         RzCoreLocked core(Core());
-        rz_core_write_string_zero_at(core, getLocationAddress(), str.toUtf8().constData());
+        rz_core_write_string_zero_at(core, address, utf8.constData());
     }
+    emit Core()->instructionChanged(address, utf8.size() + 1);
     refresh();
 }
 
@@ -1677,7 +1828,7 @@ void HexWidget::drawItemArea(QPainter &painter)
 
                 itemString = renderItem(itemAddr - startAddress, &itemColor);
 
-                if (!getFlagsAndComment(itemAddr).isEmpty()) {
+                if (hasAnnotationAt(itemAddr)) {
                     QColor markerColor(borderColor);
                     markerColor.setAlphaF(0.5);
                     painter.setPen(markerColor);
@@ -2256,6 +2407,32 @@ QString HexWidget::getFlagsAndComment(uint64_t address)
     return metaData;
 }
 
+void HexWidget::updateAnnotations()
+{
+    int size = bytesPerScreen();
+    annotationsStart = startAddress;
+    annotatedBytes.fill(false, size);
+    if (size <= 0) {
+        return;
+    }
+    uint64_t end = startAddress + uint64_t(size - 1);
+    if (end < startAddress) {
+        end = UINT64_MAX;
+    }
+    for (RVA addr : Core()->getFlagAndCommentAddresses(startAddress, end)) {
+        annotatedBytes.setBit(int(addr - annotationsStart));
+    }
+}
+
+bool HexWidget::hasAnnotationAt(uint64_t address) const
+{
+    if (address < annotationsStart
+        || address - annotationsStart >= uint64_t(annotatedBytes.size())) {
+        return false;
+    }
+    return annotatedBytes.testBit(int(address - annotationsStart));
+}
+
 bool HexWidget::canKeyboardEdit()
 {
     return ioModesController.canWrite() && actionKeyboardEdit->isChecked();
@@ -2438,6 +2615,7 @@ void HexWidget::fetchData()
 {
     data.swap(oldData);
     data->fetch(startAddress, bytesPerScreen());
+    updateAnnotations();
 }
 
 BasicCursor HexWidget::screenPosToAddr(const QPoint &point, bool middle, int *wordOffset) const
@@ -3,11 +3,14 @@
 
 #include "Cutter.h"
 #include "dialogs/HexdumpRangeDialog.h"
+#include "common/AsyncTask.h"
 #include "common/IOModesController.h"
 
+#include <QBitArray>
 #include <QScrollArea>
 #include <QTimer>
 #include <QMenu>
+#include <list>
 #include <memory>
 
 struct BasicCursor
@@ -137,17 +140,105 @@ private:
     QByteArray m_buffer;
 };
 
+class HexBlockPrefetchTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    HexBlockPrefetchTask(QVector<uint64_t> blockAddresses, int blockSize)
+        : blockAddresses(std::move(blockAddresses)), blockSize(blockSize)
+    {
+    }
+
+    QString getTitle() override { return tr("Reading memory"); }
+
+    const QVector<uint64_t> &getBlockAddresses() const { return blockAddresses; }
+    /**
+     * @brief Blocks read by the task, in the order of getBlockAddresses(). Can be shorter if the
+     * task was interrupted. Only access it after the task has finished.
+     */
+    const QVector<QByteArray> &getBlocks() const { return blocks; }
+
+protected:
+    void runTask() override
+    {
+        blocks.reserve(blockAddresses.size());
+        for (uint64_t addr : blockAddresses) {
+            if (isInterrupted()) {
+                break;
+            }
+            blocks.append(Core()->ioRead(addr, blockSize));
+        }
+    }
+
+private:
+    QVector<uint64_t> blockAddresses;
+    int blockSize;
+    QVector<QByteArray> blocks;
+};
+
+/**
+ * @brief LRU cache of memory blocks shared by the MemoryData objects of a HexWidget.
+ *
+ * Blocks next to the visible range are read ahead in a background task. Every invalidation starts
+ * a new generation and results of read-ahead started in an older generation are discarded.
+ */
+class HexBlockCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr uint64_t BLOCK_SIZE = 0x1000;
+    /**
+     * Maximum number of cached blocks, including the visible ones.
+     */
+    static constexpr int MAX_BLOCKS = 1024;
+    /**
+     * Number of blocks read ahead on each side of the visible range.
+     */
+    static constexpr int PREFETCH_BLOCKS = 16;
+
+    explicit HexBlockCache(QObject *parent = nullptr);
+    ~HexBlockCache() override;
+
+    /**
+     * @brief Get the block starting at blockAddr, reading it if it isn't cached.
+     */
+    QByteArray block(uint64_t blockAddr);
+    /**
+     * @brief Start reading the uncached blocks around [firstBlockAddr; lastBlockAddr] in the
+     * background, replacing any previous read-ahead.
+     */
+    void prefetchAround(uint64_t firstBlockAddr, uint64_t lastBlockAddr);
+    void invalidate();
+    void invalidate(uint64_t addr, uint64_t len);
+
+private:
+    struct Entry
+    {
+        QByteArray data;
+        std::list<uint64_t>::iterator lruPos;
+    };
+
+    void insert(uint64_t blockAddr, const QByteArray &data);
+    void cancelPrefetch();
+
+    QHash<uint64_t, Entry> blocks;
+    std::list<uint64_t> lru; ///< Most recently used first
+    quint64 generation = 0;
+    QSharedPointer<HexBlockPrefetchTask> prefetchTask;
+};
+
 class MemoryData : public AbstractData
 {
 public:
-    MemoryData() = default;
+    explicit MemoryData(HexBlockCache *cache) : m_cache(cache) {}
     ~MemoryData() override = default;
-    static constexpr size_t BLOCK_SIZE = 4096;
+    static constexpr size_t BLOCK_SIZE = HexBlockCache::BLOCK_SIZE;
 
     void fetch(uint64_t address, int length) override
     {
-        // FIXME: reuse data if possible
-        const uint64_t blockSize = 0x1000ULL;
+        const uint64_t blockSize = BLOCK_SIZE;
         uint64_t alignedAddr = address & ~(blockSize - 1);
         int offset = address - alignedAddr;
         int len = (offset + length + (blockSize - 1)) & ~(blockSize - 1);
@@ -160,7 +251,10 @@ public:
         m_blocks.clear();
         uint64_t addr = alignedAddr;
         for (ut64 i = 0; i < len / blockSize; ++i, addr += blockSize) {
-            m_blocks.append(Core()->ioRead(addr, blockSize));
+            m_blocks.append(m_cache->block(addr));
+        }
+        if (!m_blocks.isEmpty()) {
+            m_cache->prefetchAround(alignedAddr, alignedAddr + (m_blocks.size() - 1) * blockSize);
         }
     }
 
@@ -221,8 +315,9 @@ public:
     {
         RzCoreLocked core(Core());
         rz_core_write_at(core, adr, in, len);
+        m_cache->invalidate(adr, len);
         writeToCache(in, adr, len);
-        emit Core()->instructionChanged(adr);
+        emit Core()->instructionChanged(adr, len);
         return true;
     }
 
@@ -231,6 +326,7 @@ public:
     uint64_t minIndex() override { return m_firstBlockAddr; }
 
 private:
+    HexBlockCache *m_cache;
     QVector<QByteArray> m_blocks;
     uint64_t m_firstBlockAddr = 0;
     uint64_t m_lastValidAddr = 0;
@@ -357,6 +453,9 @@ public:
     Selection getSelection();
 public slots:
     void seek(uint64_t address);
+    /**
+     * @brief Reload all the data from the core and repaint.
+     */
     void refresh();
     void updateColors();
 signals:
@@ -424,6 +523,15 @@ private:
     QString renderItem(int offset, QColor *color = nullptr);
     QChar renderAscii(int offset, QColor *color = nullptr);
     QString getFlagsAndComment(uint64_t address);
+    /**
+     * @brief Rebuild annotatedBytes for the bytes currently on screen.
+     */
+    void updateAnnotations();
+    /**
+     * @brief Check if there is a flag or comment at address, using the annotation index.
+     * @return false for addresses outside the indexed screen range
+     */
+    bool hasAnnotationAt(uint64_t address) const;
     /**
      * @brief Get the location on which operations such as Writing should apply.
      * @return Start of selection if multiple bytes are selected. Otherwise, the curren seek of the
@@ -432,6 +540,10 @@ private:
     RVA getLocationAddress();
 
     void fetchData();
+    /**
+     * @brief Fetch the visible data, reusing cached blocks, and repaint.
+     */
+    void refreshData();
     /**
      * @brief Convert mouse position to address.
      * @param point mouse position in widget
@@ -582,6 +694,7 @@ private:
     QList<QAction *> actionsWriteString;
     QList<QAction *> actionsWriteOther;
 
+    HexBlockCache *blockCache;
     std::unique_ptr<AbstractData> oldData;
     std::unique_ptr<AbstractData> data;
     IOModesController ioModesController;
@@ -601,6 +714,13 @@ private:
     bool warningRectVisible = false;
     QRectF warningRect;
     QTimer warningTimer;
+
+    /**
+     * Bit i is set if there is a flag or comment at annotationsStart + i. Built with a single range
+     * query in fetchData() so that painting doesn't need to ask the core for every byte.
+     */
+    QBitArray annotatedBytes;
+    uint64_t annotationsStart = 0;
 };
 
 #endif // HEXWIDGET_H
@@ -77,7 +77,8 @@ HexdumpWidget::HexdumpWidget(MainWindow *main)
     connect(Config(), &Configuration::fontsUpdated, this, &HexdumpWidget::fontsUpdated);
     connect(Core(), &CutterCore::refreshAll, this, [this]() { refresh(); });
     connect(Core(), &CutterCore::refreshCodeViews, this, [this]() { refresh(); });
-    connect(Core(), &CutterCore::instructionChanged, this, [this]() { refresh(); });
+    // HexWidget reloads the changed data by itself
+    connect(Core(), &CutterCore::instructionChanged, this, &HexdumpWidget::refreshSelectionInfo);
     connect(Core(), &CutterCore::stackChanged, this, [this]() { refresh(); });
     connect(Core(), &CutterCore::registersChanged, this, [this]() { refresh(); });
 
@@ -238,7 +239,7 @@ void HexdumpWidget::updateParseWindow(RVA start_address, int size)
         tempConfig.set("asm.arch", arch).set("asm.bits", bits).set("cfg.bigendian", bigEndian);
 
         ui->hexDisasTextEdit->setPlainText(
-                selectedCommand != "" ? Core()->cmdRawAt(
+                selectedCommand != "" ? Core()->cmdRawAtReadOnly(
                         QString("%1 @! %2").arg(selectedCommand).arg(size), start_address)
                                       : "");
     } else {
@@ -111,47 +111,58 @@ void ImportsModel::reload()
     endResetModel();
 }
 
+const ImportDescription *ImportsModel::description(QModelIndex index) const
+{
+    if (index.row() < imports.size()) {
+        return &imports.at(index.row());
+    }
+    return nullptr;
+}
+
 ImportsProxyModel::ImportsProxyModel(ImportsModel *sourceModel, QObject *parent)
     : AddressableFilterProxyModel(sourceModel, parent)
 {
+    setCommentColumn(ImportsModel::CommentColumn);
     setFilterCaseSensitivity(Qt::CaseInsensitive);
     setSortCaseSensitivity(Qt::CaseInsensitive);
 }
 
 bool ImportsProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
 {
-    QModelIndex index = sourceModel()->index(row, 0, parent);
-    auto import = index.data(ImportsModel::ImportDescriptionRole).value<ImportDescription>();
+    auto source = static_cast<ImportsModel *>(sourceModel());
+    QModelIndex index = source->index(row, 0, parent);
+    const ImportDescription *import = source->description(index);
 
-    return qhelpers::filterStringContains(import.name, this);
+    return qhelpers::filterStringContains(import->name, this);
 }
 
 bool ImportsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
+    auto source = static_cast<ImportsModel *>(sourceModel());
     if (!left.isValid() || !right.isValid())
         return false;
 
     if (left.parent().isValid() || right.parent().isValid())
         return false;
 
-    auto leftImport = left.data(ImportsModel::ImportDescriptionRole).value<ImportDescription>();
-    auto rightImport = right.data(ImportsModel::ImportDescriptionRole).value<ImportDescription>();
+    const ImportDescription *leftImport = source->description(left);
+    const ImportDescription *rightImport = source->description(right);
 
     switch (left.column()) {
     case ImportsModel::AddressColumn:
-        return leftImport.plt < rightImport.plt;
+        return leftImport->plt < rightImport->plt;
     case ImportsModel::TypeColumn:
-        return leftImport.type < rightImport.type;
+        return leftImport->type < rightImport->type;
     case ImportsModel::SafetyColumn:
         break;
     case ImportsModel::LibraryColumn:
-        if (leftImport.libname != rightImport.libname)
-            return leftImport.libname < rightImport.libname;
+        if (leftImport->libname != rightImport->libname)
+            return leftImport->libname < rightImport->libname;
     // fallthrough
     case ImportsModel::NameColumn:
-        return leftImport.name < rightImport.name;
+        return leftImport->name < rightImport->name;
     case ImportsModel::CommentColumn:
-        return Core()->getCommentAt(leftImport.plt) < Core()->getCommentAt(rightImport.plt);
+        return AddressableFilterProxyModel::lessThan(left, right);
 
     default:
         break;
@@ -77,6 +77,8 @@ public:
 
     RVA address(const QModelIndex &index) const override;
     QString name(const QModelIndex &index) const override;
+
+    const ImportDescription *description(QModelIndex index) const;
     QString libname(const QModelIndex &index) const;
     void reload();
 };
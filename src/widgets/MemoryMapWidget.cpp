@@ -78,43 +78,50 @@ RVA MemoryMapModel::address(const QModelIndex &index) const
     return memoryMap.addrStart;
 }
 
+const MemoryMapDescription *MemoryMapModel::description(QModelIndex index) const
+{
+    if (index.row() < memoryMaps->size()) {
+        return &memoryMaps->at(index.row());
+    }
+    return nullptr;
+}
+
 MemoryProxyModel::MemoryProxyModel(MemoryMapModel *sourceModel, QObject *parent)
     : AddressableFilterProxyModel(sourceModel, parent)
 {
+    setCommentColumn(MemoryMapModel::CommentColumn);
 }
 
 bool MemoryProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
 {
-    QModelIndex index = sourceModel()->index(row, 0, parent);
-    MemoryMapDescription item =
-            index.data(MemoryMapModel::MemoryDescriptionRole).value<MemoryMapDescription>();
-    return qhelpers::filterStringContains(item.name, this);
+    auto source = static_cast<MemoryMapModel *>(sourceModel());
+    QModelIndex index = source->index(row, 0, parent);
+    const MemoryMapDescription *item = source->description(index);
+    return qhelpers::filterStringContains(item->name, this);
 }
 
 bool MemoryProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
-    MemoryMapDescription leftMemMap =
-            left.data(MemoryMapModel::MemoryDescriptionRole).value<MemoryMapDescription>();
-    MemoryMapDescription rightMemMap =
-            right.data(MemoryMapModel::MemoryDescriptionRole).value<MemoryMapDescription>();
+    auto source = static_cast<MemoryMapModel *>(sourceModel());
+    const MemoryMapDescription *leftMemMap = source->description(left);
+    const MemoryMapDescription *rightMemMap = source->description(right);
 
     switch (left.column()) {
     case MemoryMapModel::AddrStartColumn:
-        return leftMemMap.addrStart < rightMemMap.addrStart;
+        return leftMemMap->addrStart < rightMemMap->addrStart;
     case MemoryMapModel::AddrEndColumn:
-        return leftMemMap.addrEnd < rightMemMap.addrEnd;
+        return leftMemMap->addrEnd < rightMemMap->addrEnd;
     case MemoryMapModel::NameColumn:
-        return leftMemMap.name < rightMemMap.name;
+        return leftMemMap->name < rightMemMap->name;
     case MemoryMapModel::PermColumn:
-        return leftMemMap.permission < rightMemMap.permission;
+        return leftMemMap->permission < rightMemMap->permission;
     case MemoryMapModel::CommentColumn:
-        return Core()->getCommentAt(leftMemMap.addrStart)
-                < Core()->getCommentAt(rightMemMap.addrStart);
+        return AddressableFilterProxyModel::lessThan(left, right);
     default:
         break;
     }
 
-    return leftMemMap.addrStart < rightMemMap.addrStart;
+    return leftMemMap->addrStart < rightMemMap->addrStart;
 }
 
 MemoryMapWidget::MemoryMapWidget(MainWindow *main)
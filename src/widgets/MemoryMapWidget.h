@@ -50,6 +50,8 @@ public:
                         int role = Qt::DisplayRole) const override;
 
     RVA address(const QModelIndex &index) const override;
+
+    const MemoryMapDescription *description(QModelIndex index) const;
 };
 
 class MemoryProxyModel : public AddressableFilterProxyModel
@@ -81,41 +81,52 @@ void RelocsModel::reload()
     endResetModel();
 }
 
+const RelocDescription *RelocsModel::description(QModelIndex index) const
+{
+    if (index.row() < relocs.size()) {
+        return &relocs.at(index.row());
+    }
+    return nullptr;
+}
+
 RelocsProxyModel::RelocsProxyModel(RelocsModel *sourceModel, QObject *parent)
     : AddressableFilterProxyModel(sourceModel, parent)
 {
+    setCommentColumn(RelocsModel::CommentColumn);
     setFilterCaseSensitivity(Qt::CaseInsensitive);
     setSortCaseSensitivity(Qt::CaseInsensitive);
 }
 
 bool RelocsProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
 {
-    QModelIndex index = sourceModel()->index(row, 0, parent);
-    auto reloc = index.data(RelocsModel::RelocDescriptionRole).value<RelocDescription>();
+    auto source = static_cast<RelocsModel *>(sourceModel());
+    QModelIndex index = source->index(row, 0, parent);
+    const RelocDescription *reloc = source->description(index);
 
-    return qhelpers::filterStringContains(reloc.name, this);
+    return qhelpers::filterStringContains(reloc->name, this);
 }
 
 bool RelocsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
+    auto source = static_cast<RelocsModel *>(sourceModel());
     if (!left.isValid() || !right.isValid())
         return false;
 
     if (left.parent().isValid() || right.parent().isValid())
         return false;
 
-    auto leftReloc = left.data(RelocsModel::RelocDescriptionRole).value<RelocDescription>();
-    auto rightReloc = right.data(RelocsModel::RelocDescriptionRole).value<RelocDescription>();
+    const RelocDescription *leftReloc = source->description(left);
+    const RelocDescription *rightReloc = source->description(right);
 
     switch (left.column()) {
     case RelocsModel::VAddrColumn:
-        return leftReloc.vaddr < rightReloc.vaddr;
+        return leftReloc->vaddr < rightReloc->vaddr;
     case RelocsModel::TypeColumn:
-        return leftReloc.type < rightReloc.type;
+        return leftReloc->type < rightReloc->type;
     case RelocsModel::NameColumn:
-        return leftReloc.name < rightReloc.name;
+        return leftReloc->name < rightReloc->name;
     case RelocsModel::CommentColumn:
-        return Core()->getCommentAt(leftReloc.vaddr) < Core()->getCommentAt(rightReloc.vaddr);
+        return AddressableFilterProxyModel::lessThan(left, right);
     default:
         break;
     }
@@ -36,6 +36,8 @@ public:
     RVA address(const QModelIndex &index) const override;
     QString name(const QModelIndex &index) const override;
 
+    const RelocDescription *description(QModelIndex index) const;
+
     void reload();
 };
 
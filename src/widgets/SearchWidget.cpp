@@ -135,42 +135,50 @@ RVA SearchModel::address(const QModelIndex &index) const
     return exp.offset;
 }
 
+const SearchDescription *SearchModel::description(QModelIndex index) const
+{
+    if (index.row() < search->size()) {
+        return &search->at(index.row());
+    }
+    return nullptr;
+}
+
 SearchSortFilterProxyModel::SearchSortFilterProxyModel(SearchModel *source_model, QObject *parent)
     : AddressableFilterProxyModel(source_model, parent)
 {
+    setCommentColumn(SearchModel::COMMENT);
 }
 
 bool SearchSortFilterProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
 {
-    QModelIndex index = sourceModel()->index(row, 0, parent);
-    SearchDescription search =
-            index.data(SearchModel::SearchDescriptionRole).value<SearchDescription>();
-    return qhelpers::filterStringContains(search.code, this);
+    auto source = static_cast<SearchModel *>(sourceModel());
+    QModelIndex index = source->index(row, 0, parent);
+    const SearchDescription *search = source->description(index);
+    return qhelpers::filterStringContains(search->code, this);
 }
 
 bool SearchSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
-    SearchDescription left_search =
-            left.data(SearchModel::SearchDescriptionRole).value<SearchDescription>();
-    SearchDescription right_search =
-            right.data(SearchModel::SearchDescriptionRole).value<SearchDescription>();
+    auto source = static_cast<SearchModel *>(sourceModel());
+    const SearchDescription *left_search = source->description(left);
+    const SearchDescription *right_search = source->description(right);
 
     switch (left.column()) {
     case SearchModel::SIZE:
-        return left_search.size < right_search.size;
+        return left_search->size < right_search->size;
     case SearchModel::OFFSET:
-        return left_search.offset < right_search.offset;
+        return left_search->offset < right_search->offset;
     case SearchModel::CODE:
-        return left_search.code < right_search.code;
+        return left_search->code < right_search->code;
     case SearchModel::DATA:
-        return left_search.data < right_search.data;
+        return left_search->data < right_search->data;
     case SearchModel::COMMENT:
-        return Core()->getCommentAt(left_search.offset) < Core()->getCommentAt(right_search.offset);
+        return AddressableFilterProxyModel::lessThan(left, right);
     default:
         break;
     }
 
-    return left_search.offset < right_search.offset;
+    return left_search->offset < right_search->offset;
 }
 
 SearchWidget::SearchWidget(MainWindow *main) : CutterDockWidget(main), ui(new Ui::SearchWidget)
@@ -37,6 +37,8 @@ public:
                         int role = Qt::DisplayRole) const override;
 
     RVA address(const QModelIndex &index) const override;
+
+    const SearchDescription *description(QModelIndex index) const;
 };
 
 class SearchSortFilterProxyModel : public AddressableFilterProxyModel
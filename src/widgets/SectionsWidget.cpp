@@ -125,39 +125,48 @@ QString SectionsModel::name(const QModelIndex &index) const
     return section.name;
 }
 
+const SectionDescription *SectionsModel::description(QModelIndex index) const
+{
+    if (index.row() < sections->size()) {
+        return &sections->at(index.row());
+    }
+    return nullptr;
+}
+
 SectionsProxyModel::SectionsProxyModel(SectionsModel *sourceModel, QObject *parent)
     : AddressableFilterProxyModel(sourceModel, parent)
 {
+    setCommentColumn(SectionsModel::CommentColumn);
     setFilterCaseSensitivity(Qt::CaseInsensitive);
     setSortCaseSensitivity(Qt::CaseInsensitive);
 }
 
 bool SectionsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
-    auto leftSection = left.data(SectionsModel::SectionDescriptionRole).value<SectionDescription>();
-    auto rightSection =
-            right.data(SectionsModel::SectionDescriptionRole).value<SectionDescription>();
+    auto source = static_cast<SectionsModel *>(sourceModel());
+    const SectionDescription *leftSection = source->description(left);
+    const SectionDescription *rightSection = source->description(right);
 
     switch (left.column()) {
     default:
     case SectionsModel::NameColumn:
-        return leftSection.name < rightSection.name;
+        return leftSection->name < rightSection->name;
     case SectionsModel::SizeColumn:
-        return leftSection.size < rightSection.size;
+        return leftSection->size < rightSection->size;
     case SectionsModel::AddressColumn:
     case SectionsModel::EndAddressColumn:
-        if (leftSection.vaddr != rightSection.vaddr) {
-            return leftSection.vaddr < rightSection.vaddr;
+        if (leftSection->vaddr != rightSection->vaddr) {
+            return leftSection->vaddr < rightSection->vaddr;
         }
-        return leftSection.vsize < rightSection.vsize;
+        return leftSection->vsize < rightSection->vsize;
     case SectionsModel::VirtualSizeColumn:
-        return leftSection.vsize < rightSection.vsize;
+        return leftSection->vsize < rightSection->vsize;
     case SectionsModel::PermissionsColumn:
-        return leftSection.perm < rightSection.perm;
+        return leftSection->perm < rightSection->perm;
     case SectionsModel::EntropyColumn:
-        return leftSection.entropy < rightSection.entropy;
+        return leftSection->entropy < rightSection->entropy;
     case SectionsModel::CommentColumn:
-        return Core()->getCommentAt(leftSection.vaddr) < Core()->getCommentAt(rightSection.vaddr);
+        return AddressableFilterProxyModel::lessThan(left, right);
     }
 }
 
@@ -60,6 +60,8 @@ public:
 
     RVA address(const QModelIndex &index) const override;
     QString name(const QModelIndex &index) const override;
+
+    const SectionDescription *description(QModelIndex index) const;
 };
 
 class SectionsProxyModel : public AddressableFilterProxyModel
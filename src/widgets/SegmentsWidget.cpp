@@ -109,28 +109,37 @@ QString SegmentsModel::name(const QModelIndex &index) const
     return segment.name;
 }
 
+const SegmentDescription *SegmentsModel::description(QModelIndex index) const
+{
+    if (index.row() < segments->size()) {
+        return &segments->at(index.row());
+    }
+    return nullptr;
+}
+
 SegmentsProxyModel::SegmentsProxyModel(SegmentsModel *sourceModel, QObject *parent)
     : AddressableFilterProxyModel(sourceModel, parent)
 {
+    setCommentColumn(SegmentsModel::CommentColumn);
     setFilterCaseSensitivity(Qt::CaseInsensitive);
     setSortCaseSensitivity(Qt::CaseInsensitive);
 }
 
 bool SegmentsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
-    auto leftSegment = left.data(SegmentsModel::SegmentDescriptionRole).value<SegmentDescription>();
-    auto rightSegment =
-            right.data(SegmentsModel::SegmentDescriptionRole).value<SegmentDescription>();
+    auto source = static_cast<SegmentsModel *>(sourceModel());
+    const SegmentDescription *leftSegment = source->description(left);
+    const SegmentDescription *rightSegment = source->description(right);
     switch (left.column()) {
     case SegmentsModel::NameColumn:
-        return leftSegment.name < rightSegment.name;
+        return leftSegment->name < rightSegment->name;
     case SegmentsModel::SizeColumn:
-        return leftSegment.size < rightSegment.size;
+        return leftSegment->size < rightSegment->size;
     case SegmentsModel::AddressColumn:
     case SegmentsModel::EndAddressColumn:
-        return leftSegment.vaddr < rightSegment.vaddr;
+        return leftSegment->vaddr < rightSegment->vaddr;
     case SegmentsModel::CommentColumn:
-        return Core()->getCommentAt(leftSegment.vaddr) < Core()->getCommentAt(rightSegment.vaddr);
+        return AddressableFilterProxyModel::lessThan(left, right);
     default:
         break;
     }
@@ -44,6 +44,8 @@ public:
 
     RVA address(const QModelIndex &index) const override;
     QString name(const QModelIndex &index) const override;
+
+    const SegmentDescription *description(QModelIndex index) const;
 };
 
 class SegmentsProxyModel : public AddressableFilterProxyModel
@@ -58,6 +58,7 @@ void SimpleTextGraphView::refreshView()
 {
     initFont();
     setLayoutConfig(getLayoutConfig());
+    updateDetailLevelScales();
     saveCurrentBlock();
     loadCurrentGraph();
     if (blocks.find(selectedBlock) == blocks.end()) {
@@ -248,7 +249,15 @@ void SimpleTextGraphView::restoreCurrentBlock()
 
 void SimpleTextGraphView::paintEvent(QPaintEvent *event)
 {
-    // SimpleTextGraphView is always dirty
-    setCacheDirty();
+    // Selection is the only state drawn which changes without refreshing the whole graph
+    if (selectedBlock != paintedSelectedBlock) {
+        for (ut64 entry : { paintedSelectedBlock, selectedBlock }) {
+            auto blockIt = blocks.find(entry);
+            if (blockIt != blocks.end()) {
+                invalidateBlock(blockIt->second);
+            }
+        }
+        paintedSelectedBlock = selectedBlock;
+    }
     GraphView::paintEvent(event);
 }
@@ -79,6 +79,8 @@ protected:
 
     static const ut64 NO_BLOCK_SELECTED = RVA_INVALID;
     ut64 selectedBlock = NO_BLOCK_SELECTED;
+    /// Selected block the cached graph rendering was painted with
+    ut64 paintedSelectedBlock = NO_BLOCK_SELECTED;
     bool enableBlockSelection = true;
     bool haveAddresses = false;
 
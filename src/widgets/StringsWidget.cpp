@@ -9,14 +9,14 @@
 #include <QModelIndex>
 #include <QShortcut>
 
-StringsModel::StringsModel(QList<StringDescription> *strings, QObject *parent)
+StringsModel::StringsModel(StringDescriptionColumns *strings, QObject *parent)
     : AddressableItemModel<QAbstractListModel>(parent), strings(strings)
 {
 }
 
 int StringsModel::rowCount(const QModelIndex &) const
 {
-    return strings->count();
+    return strings->size();
 }
 
 int StringsModel::columnCount(const QModelIndex &) const
@@ -26,33 +26,32 @@ int StringsModel::columnCount(const QModelIndex &) const
 
 QVariant StringsModel::data(const QModelIndex &index, int role) const
 {
-    if (index.row() >= strings->count())
+    int row = index.row();
+    if (row >= strings->size())
         return QVariant();
 
-    const StringDescription &str = strings->at(index.row());
-
     switch (role) {
     case Qt::DisplayRole:
         switch (index.column()) {
         case StringsModel::OffsetColumn:
-            return RzAddressString(str.vaddr);
+            return RzAddressString(strings->vaddrAt(row));
         case StringsModel::StringColumn:
-            return str.string;
+            return strings->stringAt(row);
         case StringsModel::TypeColumn:
-            return str.type.toUpper();
+            return strings->typeAt(row).toUpper();
         case StringsModel::LengthColumn:
-            return QString::number(str.length);
+            return QString::number(strings->lengthAt(row));
         case StringsModel::SizeColumn:
-            return QString::number(str.size);
+            return QString::number(strings->sizeAt(row));
         case StringsModel::SectionColumn:
-            return str.section;
+            return strings->sectionAt(row);
         case StringsModel::CommentColumn:
-            return Core()->getCommentAt(str.vaddr);
+            return Core()->getCommentAt(strings->vaddrAt(row));
         default:
             return QVariant();
         }
     case StringDescriptionRole:
-        return QVariant::fromValue(str);
+        return QVariant::fromValue(strings->at(row));
     default:
         return QVariant();
     }
@@ -87,13 +86,19 @@ QVariant StringsModel::headerData(int section, Qt::Orientation, int role) const
 
 RVA StringsModel::address(const QModelIndex &index) const
 {
-    const StringDescription &str = strings->at(index.row());
-    return str.vaddr;
+    return strings->vaddrAt(index.row());
 }
 
-const StringDescription *StringsModel::description(const QModelIndex &index) const
+void StringsModel::appendStrings(const StringDescriptionColumns &newStrings)
 {
-    return &strings->at(index.row());
+    if (newStrings.isEmpty()) {
+        return;
+    }
+    int first = strings->size();
+    beginInsertRows(QModelIndex(), first, first + newStrings.size() - 1);
+    // Shares the columns of the first chunk instead of copying them
+    strings->append(newStrings);
+    endInsertRows();
 }
 
 StringsProxyModel::StringsProxyModel(StringsModel *sourceModel, QObject *parent)
@@ -101,6 +106,7 @@ StringsProxyModel::StringsProxyModel(StringsModel *sourceModel, QObject *parent)
 {
     setFilterCaseSensitivity(Qt::CaseInsensitive);
     setSortCaseSensitivity(Qt::CaseInsensitive);
+    setFilterIndexEnabled(true);
 }
 
 void StringsProxyModel::setSelectedSection(QString section)
@@ -115,43 +121,60 @@ void StringsProxyModel::setSelectedSection(QString section)
 
 bool StringsProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
 {
-    QModelIndex index = sourceModel()->index(row, 0, parent);
-    StringDescription str =
-            index.data(StringsModel::StringDescriptionRole).value<StringDescription>();
-    if (selectedSection.isEmpty()) {
-        return qhelpers::filterStringContains(str.string, this);
-    } else {
-        return selectedSection == str.section && qhelpers::filterStringContains(str.string, this);
+    if (parent.isValid()) {
+        return false;
+    }
+    const StringDescriptionColumns &strings =
+            static_cast<StringsModel *>(sourceModel())->columns();
+    if (row >= strings.size()) {
+        return false;
+    }
+    if (!selectedSection.isEmpty() && selectedSection != strings.sectionAt(row)) {
+        return false;
     }
+    return filterKeyContains(row);
 }
 
-bool StringsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+QString StringsProxyModel::filterKey(int sourceRow) const
 {
-    auto model = static_cast<StringsModel *>(sourceModel());
-    auto leftStr = model->description(left);
-    auto rightStr = model->description(right);
+    const StringDescriptionColumns &strings =
+            static_cast<StringsModel *>(sourceModel())->columns();
+    return sourceRow < strings.size() ? strings.stringAt(sourceRow) : QString();
+}
 
-    switch (left.column()) {
-    case StringsModel::OffsetColumn:
-        return leftStr->vaddr < rightStr->vaddr;
-    case StringsModel::StringColumn: // sort by string
-        return leftStr->string < rightStr->string;
-    case StringsModel::TypeColumn: // sort by type
-        return leftStr->type < rightStr->type;
-    case StringsModel::SizeColumn: // sort by size
-        return leftStr->size < rightStr->size;
-    case StringsModel::LengthColumn: // sort by length
-        return leftStr->length < rightStr->length;
+bool StringsProxyModel::sortKey(int sourceRow, int column, SortKey &key) const
+{
+    const StringDescriptionColumns &strings =
+            static_cast<StringsModel *>(sourceModel())->columns();
+    if (sourceRow >= strings.size()) {
+        return false;
+    }
+
+    switch (column) {
+    case StringsModel::StringColumn:
+        key.text = strings.stringAt(sourceRow);
+        break;
+    case StringsModel::TypeColumn:
+        key.text = strings.typeAt(sourceRow);
+        break;
+    case StringsModel::SizeColumn:
+        key.number = strings.sizeAt(sourceRow);
+        break;
+    case StringsModel::LengthColumn:
+        key.number = strings.lengthAt(sourceRow);
+        break;
     case StringsModel::SectionColumn:
-        return leftStr->section < rightStr->section;
+        key.text = strings.sectionAt(sourceRow);
+        break;
     case StringsModel::CommentColumn:
-        return Core()->getCommentAt(leftStr->vaddr) < Core()->getCommentAt(rightStr->vaddr);
+        key.text = Core()->getCommentAt(strings.vaddrAt(sourceRow));
+        break;
+    case StringsModel::OffsetColumn:
     default:
+        key.number = strings.vaddrAt(sourceRow);
         break;
     }
-
-    // fallback
-    return leftStr->vaddr < rightStr->vaddr;
+    return true;
 }
 
 StringsWidget::StringsWidget(MainWindow *main)
@@ -220,15 +243,29 @@ StringsWidget::StringsWidget(MainWindow *main)
     header->setResizeContentsPrecision(256);
 }
 
-StringsWidget::~StringsWidget() {}
+StringsWidget::~StringsWidget()
+{
+    if (task) {
+        task->interrupt();
+    }
+}
 
 void StringsWidget::refreshStrings()
 {
     if (task) {
+        // Strings of the previous search are outdated, including chunks already queued
+        task->disconnect(this);
+        task->interrupt();
         task->wait();
     }
 
-    task = QSharedPointer<StringsTask>(new StringsTask());
+    model->beginResetModel();
+    strings.clear();
+    model->endResetModel();
+    tree->showItemsNumber(0);
+
+    task = QSharedPointer<StringsTask>(new StringsTask(Config()->getStringsChunkSize()));
+    connect(task.data(), &StringsTask::stringsFound, this, &StringsWidget::stringsFound);
     connect(task.data(), &StringsTask::stringSearchFinished, this,
             &StringsWidget::stringSearchFinished);
     Core()->getAsyncTaskManager()->start(task);
@@ -250,12 +287,21 @@ void StringsWidget::refreshSectionCombo()
     proxyModel->setSelectedSection(QString());
 }
 
-void StringsWidget::stringSearchFinished(const QList<StringDescription> &strings)
+void StringsWidget::stringsFound(const StringDescriptionColumns &newStrings)
 {
-    model->beginResetModel();
-    this->strings = strings;
-    model->endResetModel();
+    if (sender() != task.data()) {
+        return;
+    }
+    model->appendStrings(newStrings);
+    tree->showItemsNumber(proxyModel->rowCount());
+}
 
+void StringsWidget::stringSearchFinished(bool complete)
+{
+    Q_UNUSED(complete)
+    if (sender() != task.data()) {
+        return;
+    }
     tree->showItemsNumber(proxyModel->rowCount());
 
     task.clear();
@@ -27,7 +27,7 @@ class StringsModel : public AddressableItemModel<QAbstractListModel>
     friend StringsWidget;
 
 private:
-    QList<StringDescription> *strings;
+    StringDescriptionColumns *strings;
 
 public:
     enum Column {
@@ -42,7 +42,7 @@ public:
     };
     static const int StringDescriptionRole = Qt::UserRole;
 
-    StringsModel(QList<StringDescription> *strings, QObject *parent = nullptr);
+    StringsModel(StringDescriptionColumns *strings, QObject *parent = nullptr);
 
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -52,7 +52,12 @@ public:
                         int role = Qt::DisplayRole) const override;
 
     RVA address(const QModelIndex &index) const override;
-    const StringDescription *description(const QModelIndex &index) const;
+    /**
+     * @return the strings shown by the model, one row per string
+     */
+    const StringDescriptionColumns &columns() const { return *strings; }
+
+    void appendStrings(const StringDescriptionColumns &newStrings);
 };
 
 class StringsProxyModel : public AddressableFilterProxyModel
@@ -65,7 +70,8 @@ public:
 
 protected:
     bool filterAcceptsRow(int row, const QModelIndex &parent) const override;
-    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+    bool sortKey(int sourceRow, int column, SortKey &key) const override;
+    QString filterKey(int sourceRow) const override;
 
     QString selectedSection;
 };
@@ -80,7 +86,8 @@ public:
 
 private slots:
     void refreshStrings();
-    void stringSearchFinished(const QList<StringDescription> &strings);
+    void stringsFound(const StringDescriptionColumns &newStrings);
+    void stringSearchFinished(bool complete);
     void refreshSectionCombo();
 
     void on_actionCopy();
@@ -92,7 +99,7 @@ private:
 
     StringsModel *model;
     StringsProxyModel *proxyModel;
-    QList<StringDescription> strings;
+    StringDescriptionColumns strings;
     CutterTreeWidget *tree;
 };
 
@@ -82,35 +82,46 @@ QString SymbolsModel::name(const QModelIndex &index) const
     return symbol.name;
 }
 
+const SymbolDescription *SymbolsModel::description(QModelIndex index) const
+{
+    if (index.row() < symbols->size()) {
+        return &symbols->at(index.row());
+    }
+    return nullptr;
+}
+
 SymbolsProxyModel::SymbolsProxyModel(SymbolsModel *sourceModel, QObject *parent)
     : AddressableFilterProxyModel(sourceModel, parent)
 {
+    setCommentColumn(SymbolsModel::CommentColumn);
     setFilterCaseSensitivity(Qt::CaseInsensitive);
     setSortCaseSensitivity(Qt::CaseInsensitive);
 }
 
 bool SymbolsProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
 {
-    QModelIndex index = sourceModel()->index(row, 0, parent);
-    auto symbol = index.data(SymbolsModel::SymbolDescriptionRole).value<SymbolDescription>();
+    auto source = static_cast<SymbolsModel *>(sourceModel());
+    QModelIndex index = source->index(row, 0, parent);
+    const SymbolDescription *symbol = source->description(index);
 
-    return qhelpers::filterStringContains(symbol.name, this);
+    return qhelpers::filterStringContains(symbol->name, this);
 }
 
 bool SymbolsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
-    auto leftSymbol = left.data(SymbolsModel::SymbolDescriptionRole).value<SymbolDescription>();
-    auto rightSymbol = right.data(SymbolsModel::SymbolDescriptionRole).value<SymbolDescription>();
+    auto source = static_cast<SymbolsModel *>(sourceModel());
+    const SymbolDescription *leftSymbol = source->description(left);
+    const SymbolDescription *rightSymbol = source->description(right);
 
     switch (left.column()) {
     case SymbolsModel::AddressColumn:
-        return leftSymbol.vaddr < rightSymbol.vaddr;
+        return leftSymbol->vaddr < rightSymbol->vaddr;
     case SymbolsModel::TypeColumn:
-        return leftSymbol.type < rightSymbol.type;
+        return leftSymbol->type < rightSymbol->type;
     case SymbolsModel::NameColumn:
-        return leftSymbol.name < rightSymbol.name;
+        return leftSymbol->name < rightSymbol->name;
     case SymbolsModel::CommentColumn:
-        return Core()->getCommentAt(leftSymbol.vaddr) < Core()->getCommentAt(rightSymbol.vaddr);
+        return AddressableFilterProxyModel::lessThan(left, right);
     default:
         break;
     }
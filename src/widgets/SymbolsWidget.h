@@ -37,6 +37,8 @@ public:
 
     RVA address(const QModelIndex &index) const override;
     QString name(const QModelIndex &index) const override;
+
+    const SymbolDescription *description(QModelIndex index) const;
 };
 
 class SymbolsProxyModel : public AddressableFilterProxyModel
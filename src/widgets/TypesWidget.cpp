@@ -95,6 +95,7 @@ bool TypesModel::removeRows(int row, int count, const QModelIndex &parent)
         types->removeAt(row);
     }
     endRemoveRows();
+    emit Core()->typesChanged();
     return true;
 }
 